@@ -0,0 +1,161 @@
+#include "AllocationPolicy.h"
+#include "ConfigParking.h"
+
+AllocationPolicy::~AllocationPolicy() {}
+
+double AllocationPolicy::entranceDistance(const std::string& slotId) {
+    for (const auto& def : ParkingLayout::DEFAULT_SLOTS) {
+        if (def.id == slotId) return def.entranceDistance;
+    }
+    return ParkingLayout::UNKNOWN_SLOT_DISTANCE;
+}
+
+size_t AllocationPolicy::bucketIndex(const ParkingSlot& slot) {
+    return static_cast<size_t>(slot.getLevel()) * BUCKETS_PER_FLOOR
+         + static_cast<int>(slot.getKind()) * CAPABILITY_CLASSES
+         + (slot.getCapabilities() & VehicleAttribute::ALL);
+}
+
+bool AllocationPolicy::bucketFits(size_t index, const Vehicle& v) {
+    unsigned capabilities = static_cast<unsigned>(index % CAPABILITY_CLASSES);
+    return (v.getAttributes() & ~capabilities) == 0;
+}
+
+int AllocationPolicy::surplus(size_t index, const Vehicle& v) {
+    unsigned unused = static_cast<unsigned>(index % CAPABILITY_CLASSES) & ~v.getAttributes();
+    int count = 0;
+    for (; unused; unused &= unused - 1) count++;
+    return count;
+}
+
+int AllocationPolicy::cost(size_t index, const Vehicle& v) {
+    SlotKind kind = static_cast<SlotKind>(index % BUCKETS_PER_FLOOR / CAPABILITY_CLASSES);
+    bool spareVip = kind == SlotKind::VIP && !(v.getAttributes() & VehicleAttribute::OVERSIZED);
+    // Outweighs any surplus, so a VIP bay never beats a free regular one
+    return (spareVip ? CAPABILITY_CLASSES : 0) + surplus(index, v);
+}
+
+std::set<AllocationPolicy::Entry>* AllocationPolicy::bucket(const ParkingSlot& slot) {
+    if (slot.getLevel() < 0) return nullptr;
+    size_t index = bucketIndex(slot);
+    if (index >= freeSlots.size()) freeSlots.resize(index + 1);
+    return &freeSlots[index];
+}
+
+void AllocationPolicy::attach(const std::vector<std::shared_ptr<ParkingSlot>>& slots) {
+    slotTable.clear();
+    ranks.clear();
+    indexOf.clear();
+    freeSlots.clear();
+    for (size_t i = 0; i < slots.size(); i++) {
+        ParkingSlot* slot = slots[i].get();
+        slotTable.push_back(slot);
+        ranks.push_back(rank(*slot, i));
+        indexOf[slot] = i;
+        std::set<Entry>* entries = bucket(*slot);
+        if (entries && !slot->isOccupied()) {
+            entries->insert(Entry(ranks[i], i));
+        }
+    }
+}
+
+ParkingSlot* AllocationPolicy::firstCompatible(const std::set<Entry>& entries, const Vehicle& v) const {
+    for (const auto& entry : entries) {
+        ParkingSlot* slot = slotTable[entry.second];
+        if (slot->canPark(v)) return slot;
+        // Regular and EV slots accept or reject by vehicle type alone, so
+        // only VIP slots (reservations) are worth looking past
+        if (slot->getKind() != SlotKind::VIP) return nullptr;
+    }
+    return nullptr;
+}
+
+ParkingSlot* AllocationPolicy::select(const Vehicle& v) {
+    ParkingSlot* best = nullptr;
+    int bestCost = 0;
+    double bestRank = 0;
+    for (size_t index = 0; index < freeSlots.size(); index++) {
+        const std::set<Entry>& entries = freeSlots[index];
+        if (entries.empty() || !bucketFits(index, v)) continue;
+        int extra = cost(index, v);
+        if (best && (extra > bestCost || (extra == bestCost && entries.begin()->first >= bestRank))) continue;
+        ParkingSlot* candidate = firstCompatible(entries, v);
+        if (!candidate) continue;
+        double candidateRank = ranks[indexOf[candidate]];
+        if (!best || extra < bestCost || candidateRank < bestRank) {
+            best = candidate;
+            bestCost = extra;
+            bestRank = candidateRank;
+        }
+    }
+    return best;
+}
+
+void AllocationPolicy::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    auto it = indexOf.find(&slot);
+    if (it == indexOf.end()) return;
+    std::set<Entry>* entries = bucket(slot);
+    if (entries) entries->erase(Entry(ranks[it->second], it->second));
+}
+
+void AllocationPolicy::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    auto it = indexOf.find(&slot);
+    if (it == indexOf.end()) return;
+    std::set<Entry>* entries = bucket(slot);
+    if (entries) entries->insert(Entry(ranks[it->second], it->second));
+}
+
+// NearestEntrancePolicy implementation
+double NearestEntrancePolicy::rank(const ParkingSlot& slot, size_t index) const {
+    return entranceDistance(slot.getId());
+}
+
+// FloorByFloorPolicy implementation
+double FloorByFloorPolicy::rank(const ParkingSlot& slot, size_t index) const {
+    // Floor dominates; vector order breaks ties within a floor
+    return slot.getLevel() * 1e6 + static_cast<double>(index);
+}
+
+// SpreadFloorsPolicy implementation
+double SpreadFloorsPolicy::rank(const ParkingSlot& slot, size_t index) const {
+    return entranceDistance(slot.getId());
+}
+
+ParkingSlot* SpreadFloorsPolicy::select(const Vehicle& v) {
+    // Lowest cost (slot kind, then surplus capability) first, then the floor
+    // with the most free compatible slots, then the nearest slot
+    ParkingSlot* best = nullptr;
+    int bestCost = 0;
+    size_t bestFree = 0;
+    double bestRank = 0;
+    size_t floors = freeSlots.size() / BUCKETS_PER_FLOOR + 1;
+    for (size_t floor = 0; floor < floors; floor++) {
+        size_t freeCount = 0;
+        ParkingSlot* floorBest = nullptr;
+        int floorCost = 0;
+        for (int b = 0; b < BUCKETS_PER_FLOOR; b++) {
+            size_t index = floor * BUCKETS_PER_FLOOR + b;
+            if (index >= freeSlots.size() || freeSlots[index].empty() || !bucketFits(index, v)) continue;
+            ParkingSlot* candidate = firstCompatible(freeSlots[index], v);
+            if (!candidate) continue;
+            freeCount += freeSlots[index].size();
+            int extra = cost(index, v);
+            if (!floorBest || extra < floorCost
+                || (extra == floorCost && ranks[indexOf[candidate]] < ranks[indexOf[floorBest]])) {
+                floorBest = candidate;
+                floorCost = extra;
+            }
+        }
+        if (!floorBest) continue;
+        double floorRank = ranks[indexOf[floorBest]];
+        if (!best || floorCost < bestCost
+            || (floorCost == bestCost
+                && (freeCount > bestFree || (freeCount == bestFree && floorRank < bestRank)))) {
+            best = floorBest;
+            bestCost = floorCost;
+            bestFree = freeCount;
+            bestRank = floorRank;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,80 @@
+#ifndef ALLOCATIONPOLICY_H
+#define ALLOCATIONPOLICY_H
+
+#include "ParkingObserver.h"
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Chooses a free slot for a vehicle. Each policy ranks the slots once when
+// attached and keeps the free ones in ordered sets per floor, slot kind and
+// capability class, kept current through park/unpark events. Buckets whose
+// capabilities do not cover the vehicle's attributes are skipped with one
+// mask test, so a choice costs O(buckets * log n) instead of a scan over
+// every slot. Among fitting buckets VIP bays come last unless the vehicle
+// needs an oversize bay, then the bucket with the fewest capabilities the
+// vehicle does not need wins, then the rank, so plain vehicles leave VIP,
+// accessible and high-clearance bays for those who need them.
+// Re-attach after changing slot capabilities.
+class AllocationPolicy : public ParkingObserver {
+protected:
+    typedef std::pair<double, size_t> Entry; // (rank, slot index)
+    
+    std::vector<ParkingSlot*> slotTable;
+    std::vector<double> ranks;
+    std::unordered_map<const ParkingSlot*, size_t> indexOf;
+    std::vector<std::set<Entry>> freeSlots; // indexed by bucketIndex()
+    
+    static const int KINDS = 3;
+    static const int CAPABILITY_CLASSES = VehicleAttribute::ALL + 1;
+    static const int BUCKETS_PER_FLOOR = KINDS * CAPABILITY_CLASSES;
+    
+    static size_t bucketIndex(const ParkingSlot& slot);
+    static bool bucketFits(size_t index, const Vehicle& v);
+    // Capabilities of the bucket that v does not use
+    static int surplus(size_t index, const Vehicle& v);
+    // Lower is better: VIP buckets rank after all others unless v is
+    // oversized, then by surplus
+    static int cost(size_t index, const Vehicle& v);
+    std::set<Entry>* bucket(const ParkingSlot& slot);
+    // First free slot in the bucket that accepts v (skips reserved VIP slots)
+    ParkingSlot* firstCompatible(const std::set<Entry>& entries, const Vehicle& v) const;
+    
+    virtual double rank(const ParkingSlot& slot, size_t index) const = 0;
+
+public:
+    virtual ~AllocationPolicy();
+    
+    void attach(const std::vector<std::shared_ptr<ParkingSlot>>& slots);
+    virtual ParkingSlot* select(const Vehicle& v);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    static double entranceDistance(const std::string& slotId);
+};
+
+// Shortest walk/drive from the floor 1 entrance (ParkingLayout distances)
+class NearestEntrancePolicy : public AllocationPolicy {
+protected:
+    double rank(const ParkingSlot& slot, size_t index) const override;
+};
+
+// Fills the lowest floor completely before opening the next one
+class FloorByFloorPolicy : public AllocationPolicy {
+protected:
+    double rank(const ParkingSlot& slot, size_t index) const override;
+};
+
+// Sends each vehicle to the floor with the most free compatible slots and
+// the nearest slot on that floor, spreading ramp traffic
+class SpreadFloorsPolicy : public AllocationPolicy {
+protected:
+    double rank(const ParkingSlot& slot, size_t index) const override;
+public:
+    ParkingSlot* select(const Vehicle& v) override;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef BROADCASTRING_H
+#define BROADCASTRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Bounded lock-free single-producer/multi-consumer broadcast ring. Every
+// consumer sees every item through its own position; consumers never write
+// shared state, so adding readers costs the producer nothing. The producer
+// never waits either: it overwrites the oldest item, and a reader that
+// falls a full ring behind gets OVERRUN and must resynchronise. Each cell
+// is a seqlock over atomic words, so a torn read is detected, not returned.
+template <typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing items must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "BroadcastRing items must be a whole number of 64-bit words");
+    
+public:
+    enum ReadResult { OK, EMPTY, OVERRUN };
+    
+private:
+    static const size_t WORDS = sizeof(T) / sizeof(uint64_t);
+    
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> sequence; // 2 * position + 2 once written, odd while writing
+        std::atomic<uint64_t> words[WORDS];
+    };
+    
+    std::vector<Cell> cells;
+    uint64_t mask;
+    alignas(64) std::atomic<uint64_t> head; // items published so far
+    
+public:
+    explicit BroadcastRing(size_t capacity) : head(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        cells = std::vector<Cell>(size);
+        for (Cell& cell : cells) {
+            cell.sequence.store(0, std::memory_order_relaxed);
+        }
+        mask = size - 1;
+    }
+    
+    size_t capacity() const { return cells.size(); }
+    
+    // Position the next published item will get
+    uint64_t position() const { return head.load(std::memory_order_acquire); }
+    
+    // Producer only
+    void publish(const T& item) {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        Cell& cell = cells[pos & mask];
+        uint64_t words[WORDS];
+        std::memcpy(words, &item, sizeof(T));
+        cell.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            cell.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        cell.sequence.store(2 * pos + 2, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_release);
+    }
+    
+    // Item at `pos`, if still in the ring
+    ReadResult read(uint64_t pos, T& item) const {
+        uint64_t published = head.load(std::memory_order_acquire);
+        if (pos >= published) return EMPTY;
+        if (published - pos > cells.size()) return OVERRUN;
+        
+        const Cell& cell = cells[pos & mask];
+        uint64_t before = cell.sequence.load(std::memory_order_acquire);
+        if (before != 2 * pos + 2) return OVERRUN;
+        uint64_t words[WORDS];
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i] = cell.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (cell.sequence.load(std::memory_order_relaxed) != before) return OVERRUN;
+        std::memcpy(&item, words, sizeof(T));
+        return OK;
+    }
+};
+
+#endif
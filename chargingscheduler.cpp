@@ -0,0 +1,174 @@
+#include "ChargingScheduler.h"
+#include "ConfigParking.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <cmath>
+
+ChargingScheduler::ChargingScheduler(double siteBudgetKW, double stationMaxKW)
+    : stationPower(stationMaxKW), partialTicket(-1) {
+    fullSlots = stationMaxKW > 0 ? static_cast<size_t>(siteBudgetKW / stationMaxKW) : 0;
+    remainderPower = siteBudgetKW - fullSlots * stationMaxKW;
+}
+
+ChargingScheduler::Key ChargingScheduler::keyOf(const ChargingSession& session) {
+    return Key(session.departure, session.ticketId);
+}
+
+void ChargingScheduler::accrue(ChargingSession& session, time_t now) {
+    if (now > session.lastUpdate && session.allocatedKW > 0) {
+        double energy = session.allocatedKW * (now - session.lastUpdate) / 3600.0;
+        session.deliveredKWh = std::min(session.requestedKWh, session.deliveredKWh + energy);
+    }
+    session.lastUpdate = std::max(session.lastUpdate, now);
+}
+
+void ChargingScheduler::setPower(ChargingSession& session, double kw, time_t now) {
+    accrue(session, now);
+    if (session.allocatedKW > 0) {
+        finishing.erase(Key(session.expectedCompletion, session.ticketId));
+    }
+    session.allocatedKW = kw;
+    if (kw > 0) {
+        double remaining = session.requestedKWh - session.deliveredKWh;
+        session.expectedCompletion = now + static_cast<time_t>(std::ceil(remaining / kw * 3600.0));
+        finishing.insert(Key(session.expectedCompletion, session.ticketId));
+    }
+}
+
+void ChargingScheduler::insert(ChargingSession& session, time_t now) {
+    Key key = keyOf(session);
+    if (active.size() < fullSlots) {
+        active.insert(key);
+        setPower(session, stationPower, now);
+    } else if (!active.empty() && key < *active.rbegin()) {
+        // Displace the latest-departing active session
+        Key worst = *active.rbegin();
+        active.erase(worst);
+        waiting.insert(worst);
+        setPower(sessions[worst.second], 0, now);
+        active.insert(key);
+        setPower(session, stationPower, now);
+    } else {
+        waiting.insert(key);
+    }
+    assignRemainder(now);
+}
+
+void ChargingScheduler::erase(ChargingSession& session, time_t now) {
+    Key key = keyOf(session);
+    bool wasActive = active.erase(key) > 0;
+    waiting.erase(key);
+    setPower(session, 0, now);
+    if (partialTicket == session.ticketId) {
+        partialTicket = -1;
+    }
+    if (wasActive && !waiting.empty()) {
+        Key next = *waiting.begin();
+        waiting.erase(waiting.begin());
+        active.insert(next);
+        setPower(sessions[next.second], stationPower, now);
+        if (partialTicket == next.second) {
+            partialTicket = -1;
+        }
+    }
+    assignRemainder(now);
+}
+
+void ChargingScheduler::assignRemainder(time_t now) {
+    int best = (waiting.empty() || remainderPower <= 0) ? -1 : waiting.begin()->second;
+    if (best == partialTicket) return;
+    if (partialTicket >= 0) {
+        auto it = sessions.find(partialTicket);
+        if (it != sessions.end() && waiting.count(keyOf(it->second))) {
+            setPower(it->second, 0, now);
+        }
+    }
+    if (best >= 0) {
+        setPower(sessions[best], remainderPower, now);
+    }
+    partialTicket = best;
+}
+
+void ChargingScheduler::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    if (slot.getKind() != SlotKind::EV) return;
+    auto ev = std::dynamic_pointer_cast<EV>(ticket.getVehicle());
+    if (!ev || !ev->needsCharging()) return;
+    
+    advance(when);
+    ChargingSession session;
+    session.ticketId = ticket.getId();
+    session.slotId = slot.getId();
+    session.requestedKWh = ev->getEnergyRequest() > 0 ? ev->getEnergyRequest()
+                                                      : ChargingConfig::DEFAULT_ENERGY_REQUEST_KWH;
+    session.deliveredKWh = 0;
+    session.allocatedKW = 0;
+    session.departure = when + (ev->getPlannedStayMinutes() > 0 ? ev->getPlannedStayMinutes() * 60
+                                                                : ChargingConfig::DEFAULT_STAY_HOURS * 3600);
+    session.lastUpdate = when;
+    session.expectedCompletion = 0;
+    session.complete = false;
+    ChargingSession& stored = sessions[session.ticketId] = session;
+    insert(stored, when);
+}
+
+void ChargingScheduler::setRequest(int ticketId, double energyKWh, time_t departure, time_t now) {
+    if (!EV::validChargingRequest(energyKWh, departure > now ? (departure - now) / 60.0 : 0)) {
+        throw ParkingException("Invalid charging request");
+    }
+    auto it = sessions.find(ticketId);
+    if (it == sessions.end()) return;
+    ChargingSession& session = it->second;
+    advance(now);
+    if (!session.complete) {
+        erase(session, now);
+    }
+    session.requestedKWh = energyKWh;
+    session.departure = departure;
+    session.complete = session.deliveredKWh >= session.requestedKWh;
+    if (!session.complete) {
+        insert(session, now);
+    }
+}
+
+void ChargingScheduler::advance(time_t now) {
+    while (!finishing.empty() && finishing.begin()->first <= now) {
+        ChargingSession& session = sessions[finishing.begin()->second];
+        time_t doneAt = finishing.begin()->first;
+        accrue(session, doneAt);
+        session.deliveredKWh = session.requestedKWh;
+        session.complete = true;
+        erase(session, doneAt);
+    }
+}
+
+double ChargingScheduler::settle(int ticketId, time_t now) {
+    auto it = sessions.find(ticketId);
+    if (it == sessions.end()) return 0.0;
+    advance(now);
+    ChargingSession& session = it->second;
+    if (!session.complete) {
+        erase(session, now);
+    }
+    double charge = std::round(session.deliveredKWh * ChargingConfig::ENERGY_RATE_PER_KWH);
+    sessions.erase(it);
+    return charge;
+}
+
+double ChargingScheduler::deliveredAt(int ticketId, time_t when) const {
+    auto it = sessions.find(ticketId);
+    if (it == sessions.end()) return 0.0;
+    const ChargingSession& session = it->second;
+    double delivered = session.deliveredKWh;
+    if (when > session.lastUpdate && session.allocatedKW > 0) {
+        delivered += session.allocatedKW * (when - session.lastUpdate) / 3600.0;
+    }
+    return std::min(session.requestedKWh, delivered);
+}
+
+const ChargingSession* ChargingScheduler::getSession(int ticketId) const {
+    auto it = sessions.find(ticketId);
+    return it == sessions.end() ? nullptr : &it->second;
+}
+
+size_t ChargingScheduler::activeSessions() const { return active.size(); }
+size_t ChargingScheduler::waitingSessions() const { return waiting.size(); }
@@ -0,0 +1,73 @@
+#ifndef CHARGINGSCHEDULER_H
+#define CHARGINGSCHEDULER_H
+
+#include "ParkingObserver.h"
+#include <ctime>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+struct ChargingSession {
+    int ticketId;
+    std::string slotId;
+    double requestedKWh;
+    double deliveredKWh;
+    double allocatedKW;
+    time_t departure;
+    time_t lastUpdate;
+    time_t expectedCompletion; // only meaningful while allocatedKW > 0
+    bool complete;
+};
+
+// Shares the site power budget between EV charging sessions, earliest
+// departure first. As many sessions as the budget allows run at full station
+// power; the next one in line gets the remainder and the rest wait. Every
+// arrival, departure or completed session moves at most a couple of
+// sessions between the ordered sets, so each event costs O(log n).
+class ChargingScheduler : public ParkingObserver {
+private:
+    typedef std::pair<time_t, int> Key; // (departure or completion time, ticket id)
+    
+    std::unordered_map<int, ChargingSession> sessions;
+    std::set<Key> active;     // running at full station power
+    std::set<Key> waiting;    // queued; the first one may get the remainder
+    std::set<Key> finishing;  // predicted completion of powered sessions
+    double stationPower;
+    size_t fullSlots;
+    double remainderPower;
+    int partialTicket;
+    
+    static Key keyOf(const ChargingSession& session);
+    void accrue(ChargingSession& session, time_t now);
+    void setPower(ChargingSession& session, double kw, time_t now);
+    void insert(ChargingSession& session, time_t now);
+    void erase(ChargingSession& session, time_t now);
+    void assignRemainder(time_t now);
+
+public:
+    ChargingScheduler(double siteBudgetKW, double stationMaxKW);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    
+    // Updates the driver's request; the session is re-queued in O(log n).
+    // Throws ParkingException for a request EV::validChargingRequest rejects.
+    void setRequest(int ticketId, double energyKWh, time_t departure, time_t now);
+    
+    // Marks sessions whose energy request has been met, freeing their power
+    void advance(time_t now);
+    
+    // Ends the session and returns the charge for energy delivered
+    double settle(int ticketId, time_t now);
+    
+    // Energy delivered by `when` if the current allocation holds until then;
+    // 0 for an unknown session. Call advance(when) first so completions and
+    // the power they free are applied.
+    double deliveredAt(int ticketId, time_t when) const;
+    
+    const ChargingSession* getSession(int ticketId) const;
+    size_t activeSessions() const;
+    size_t waitingSessions() const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef CONFIG_PARKING_H
 #define CONFIG_PARKING_H
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,20 @@ namespace ParkingRate {
     // Diskon
     const double LONG_TERM_DISCOUNT_PERCENTAGE = 10.0; // 10% diskon
     const int LONG_TERM_DISCOUNT_HOURS = 24; // Minimal jam untuk diskon
+    const double MEMBER_DISCOUNT_PERCENTAGE = 5.0; // Diskon member (tarifdetail.txt III.2)
+    
+    // Jam sibuk hari kerja (lihat tarifdetail.txt bagian VII)
+    const int PEAK_MORNING_START_HOUR = 7;
+    const int PEAK_MORNING_END_HOUR = 9;
+    const double PEAK_MORNING_SURCHARGE_PERCENTAGE = 20.0;
+    const int PEAK_EVENING_START_HOUR = 16;
+    const int PEAK_EVENING_END_HOUR = 19;
+    const double PEAK_EVENING_SURCHARGE_PERCENTAGE = 30.0;
+    
+    // Tarif dinamis berbasis okupansi: di atas ambang utilisasi tarif naik
+    // linear hingga pengali maksimum saat lantai/tipe slot penuh
+    const double DYNAMIC_PRICING_THRESHOLD_PERCENTAGE = 50.0;
+    const double DYNAMIC_PRICING_MAX_MULTIPLIER = 1.5;
     
     // Durasi minimum parkir (dalam jam)
     const int MINIMUM_PARKING_HOURS = 1;
@@ -40,28 +55,59 @@ namespace ParkingLayout {
         std::string type;  // "REGULAR", "EV", "VIP"
         int level;
         bool isActive;
+        double entranceDistance; // meter dari entrance lantai 1 (lewat ramp untuk lantai 2)
+    };
+    
+    // Versi constexpr dari definisi slot, dipakai layout statis
+    // (lihat staticlayout.h) tanpa alokasi heap
+    struct SlotSpec {
+        const char* id;
+        const char* type;
+        int level;
+        bool isActive;
+        double entranceDistance;
     };
     
     // Default slot configuration
-    const std::vector<SlotDefinition> DEFAULT_SLOTS = {
+    constexpr std::array<SlotSpec, 10> SLOT_TABLE = {{
         // Lantai 1 - Regular Slots
-        {"R1", "REGULAR", 1, true},
-        {"R2", "REGULAR", 1, true},
-        {"R3", "REGULAR", 1, true},
+        {"R1", "REGULAR", 1, true, 7.25},
+        {"R2", "REGULAR", 1, true, 9.75},
+        {"R3", "REGULAR", 1, true, 12.25},
         
         // Lantai 1 - EV Slots
-        {"E1", "EV", 1, true},
-        {"E2", "EV", 1, true},
+        {"E1", "EV", 1, true, 12.25},
+        {"E2", "EV", 1, true, 14.75},
         
         // Lantai 2 - VIP Slots
-        {"V1", "VIP", 2, true},
-        {"V2", "VIP", 2, true},
-        {"V3", "VIP", 2, true},
+        {"V1", "VIP", 2, true, 47.75},
+        {"V2", "VIP", 2, true, 50.75},
+        {"V3", "VIP", 2, true, 53.75},
         
         // Lantai 2 - Regular Slots (tambahan)
-        {"R4", "REGULAR", 2, true},
-        {"R5", "REGULAR", 2, true}
-    };
+        {"R4", "REGULAR", 2, true, 52.25},
+        {"R5", "REGULAR", 2, true, 54.75}
+    }};
+    
+    inline std::vector<SlotDefinition> expandSlotTable() {
+        std::vector<SlotDefinition> slots;
+        for (const SlotSpec& spec : SLOT_TABLE) {
+            slots.push_back({spec.id, spec.type, spec.level, spec.isActive, spec.entranceDistance});
+        }
+        return slots;
+    }
+    
+    const std::vector<SlotDefinition> DEFAULT_SLOTS = expandSlotTable();
+    
+    // Batas tinggi kendaraan per lantai (meter)
+    const double FLOOR_1_MAX_HEIGHT_M = 2.2;
+    const double FLOOR_2_MAX_HEIGHT_M = 2.0;
+    
+    // Slot yang berada di baris parkir difabel dekat entrance lantai 1
+    const std::vector<std::string> ACCESSIBLE_SLOT_IDS = { "R1" };
+    
+    // Jarak tempuh untuk slot yang tidak ada di DEFAULT_SLOTS
+    const double UNKNOWN_SLOT_DISTANCE = 1000.0;
     
     // Kapasitas per lantai
     const int FLOOR_1_CAPACITY = 5;
@@ -86,6 +132,10 @@ namespace SystemConfig {
     // ID awal untuk tiket
     const int INITIAL_TICKET_ID = 1000;
     
+    // Tiket dari lot multi-fasilitas: (shard + 1) * STRIDE + nomor urut,
+    // sehingga shard bisa dibaca langsung dari ID tiket
+    const int SHARD_TICKET_ID_STRIDE = 10000000;
+    
     // Format tanggal/waktu
     const std::string TIME_FORMAT = "%Y-%m-%d %H:%M:%S";
     const std::string DATE_FORMAT = "%Y-%m-%d";
@@ -94,13 +144,178 @@ namespace SystemConfig {
     const bool ENABLE_VIP_RESERVATION = true;
     const bool ENABLE_EV_CHARGING = true;
     const bool ENABLE_LONG_TERM_DISCOUNT = true;
+    const bool ENABLE_DYNAMIC_PRICING = false;
+    const bool ENABLE_MEMBER_DISCOUNT = true;
+    
+    // Daftar member: satu baris "plat,nama" per member
+    const std::string MEMBER_REGISTRY_FILE = "members.csv";
+    
+    // Kebijakan alokasi slot: "FIRST_FIT", "NEAREST_ENTRANCE",
+    // "FLOOR_BY_FLOOR" atau "SPREAD_FLOORS"
+    const std::string ALLOCATION_POLICY = "NEAREST_ENTRANCE";
     
     // Waktu operasional
     const int OPENING_HOUR = 6;   // Buka jam 6 pagi
     const int CLOSING_HOUR = 22;  // Tutup jam 10 malam
+    const bool ENFORCE_OPERATING_HOURS = true; // tolak masuk di luar jam buka
+    
+    // Batas antrean input per terminal (sesi coroutine)
+    const size_t TERMINAL_MAX_PENDING_LINES = 16;
+    const size_t TERMINAL_MAX_LINE_LENGTH = 256;        // baris lebih panjang: koneksi ditutup
+    const size_t TERMINAL_MAX_OUTPUT_BYTES = 64 * 1024; // terminal yang tidak membaca ditutup
+    const int TERMINAL_WORKER_THREADS = 4;
+    
+    // Interval refresh layar okupansi lobby (--server ... --display)
+    const int DISPLAY_REFRESH_MS = 1000;
+    
+    // Kapasitas ring feed perubahan okupansi (papan "FREE" dan aplikasi);
+    // pelanggan yang tertinggal lebih dari ini harus sinkron ulang
+    const size_t OCCUPANCY_FEED_CAPACITY = 4096;
+    // Jeda polling papan "FREE" saat tidak ada perubahan
+    const int SIGN_POLL_MS = 50;
+    
+    // Pencarian plat fuzzy (tiket hilang, salah baca kamera): kendaraan yang
+    // keluar tetap dicari selama N jam; jarak dalam setengah edit
+    // (1 = tertukar karakter mirip seperti 0/O, 2 = salah ketik biasa)
+    const int FUZZY_RECENT_HOURS = 24;
+    const int FUZZY_MAX_DISTANCE = 2;
+    const size_t FUZZY_MAX_RESULTS = 5;
+    
+    // Daftar tunggu saat slot penuh: kendaraan langsung mendapat slot yang
+    // baru kosong. Kedalaman pencarian per antrean saat slot dibebaskan
+    const bool ENABLE_WAITLIST = true;
+    const int WAITLIST_SCAN_DEPTH = 8;
+    // Jumlah penugasan terakhir (nomor tunggu -> tiket) yang masih bisa dicek
+    const size_t WAITLIST_ASSIGNMENT_HISTORY = 10000;
+    
+    // Ingest pembacaan plat kamera (ANPR)
+    const int PLATE_DEDUP_WINDOW_SECONDS = 30;
+    const size_t PLATE_INGEST_BATCH_SIZE = 256;
+    const size_t PLATE_INGEST_QUEUE_CAPACITY = 1 << 16;
     
     // Interval laporan
     const int REPORT_GENERATION_INTERVAL_HOURS = 24;
+    
+    // Direktori riwayat pembayaran (kolumnar, dipartisi per hari)
+    const std::string PAYMENT_HISTORY_DIR = "payment_history";
+    // Baris yang ditulis sekaligus; rows.count diperbarui sekali per batch
+    const size_t PAYMENT_HISTORY_COMMIT_ROWS = 64;
+    
+    // Indeks riwayat parkir per plat: run terurut (plat, jam masuk) di disk,
+    // digabung per STAY_COMPACTION_FANIN run berukuran serupa
+    const std::string STAY_INDEX_DIR = "stay_index";
+    const size_t STAY_MEMTABLE_RECORDS = 4096;
+    const size_t STAY_BLOCK_RECORDS = 64;
+    const size_t STAY_COMPACTION_FANIN = 4;
+    const int STAY_HISTORY_DAYS = 90;
+    
+    // Direktori catatan tutup buku harian
+    const std::string DAILY_CLOSE_DIR = "daily_close";
+}
+
+// ============================================
+// KONFIGURASI CHARGING EV
+// ============================================
+
+namespace ChargingConfig {
+    // Anggaran daya seluruh lokasi dan daya maksimum per stasiun (kW)
+    const double SITE_POWER_BUDGET_KW = 22.0;
+    const double STATION_MAX_POWER_KW = 11.0;
+    
+    // Tarif energi yang benar-benar tersalurkan (Rupiah per kWh)
+    const double ENERGY_RATE_PER_KWH = 2500.0;
+    
+    // Nilai default jika pengemudi tidak mengisi permintaan
+    const double DEFAULT_ENERGY_REQUEST_KWH = 20.0;
+    const int DEFAULT_STAY_HOURS = 4;
+    
+    // Batas permintaan yang diterima; di luar ini ditolak
+    const double MAX_ENERGY_REQUEST_KWH = 200.0;
+    const int MAX_STAY_HOURS = 168;
+}
+
+// ============================================
+// KONFIGURASI PEMBAYARAN KARTU
+// ============================================
+
+namespace PaymentConfig {
+    // Debit/Kredit diproses asinkron lewat gateway; tunai langsung lunas
+    const bool ENABLE_CARD_PAYMENT = true;
+    
+    // Pengiriman ke gateway dalam batch; batch parsial dikirim setelah interval
+    const size_t GATEWAY_BATCH_SIZE = 32;
+    const int GATEWAY_FLUSH_INTERVAL_MS = 50;
+    
+    // Percobaan maksimum per transaksi, jeda awal antar-percobaan (berlipat ganda)
+    const int MAX_PAYMENT_ATTEMPTS = 3;
+    const int RETRY_BACKOFF_MS = 200;
+    
+    // Jumlah status pembayaran selesai (lunas/gagal) yang disimpan untuk dicek
+    const size_t PAYMENT_STATUS_HISTORY = 10000;
+    
+    // Gateway tiruan lokal: latensi per batch dan peluang gagal per transaksi
+    const int MOCK_GATEWAY_LATENCY_MS = 150;
+    const double MOCK_GATEWAY_TRANSIENT_RATE = 0.05;
+    const double MOCK_GATEWAY_DECLINE_RATE = 0.01;
+}
+
+// ============================================
+// KONFIGURASI ROLLUP OKUPANSI
+// ============================================
+
+namespace RollupConfig {
+    // Jumlah lantai maksimum yang dilacak (lantai 0 = seluruh gedung)
+    const int MAX_FLOORS = 4;
+    
+    // Panjang ring buffer per tingkat
+    const int MINUTE_BUCKETS = 24 * 60;      // 1 hari per menit
+    const int HOUR_BUCKETS = 90 * 24;        // 90 hari per jam
+    const int DAY_BUCKETS = 2 * 366;         // 2 tahun per hari
+}
+
+// ============================================
+// KONFIGURASI PRAKIRAAN OKUPANSI
+// ============================================
+
+namespace ForecastConfig {
+    // Lebar langkah model (menit); harus membagi habis 24 jam
+    const int STEP_MINUTES = 15;
+    
+    // Konstanta pemulusan Holt-Winters: level, tren, musiman harian, mingguan.
+    // Level dibuat lambat agar pola harian tertangkap oleh suku musiman
+    const double LEVEL_SMOOTHING = 0.02;
+    const double TREND_SMOOTHING = 0.001;
+    const double DAILY_SMOOTHING = 0.3;
+    const double WEEKLY_SMOOTHING = 0.1;
+    
+    // Rentang prakiraan "penuh dalam ~N menit"
+    const int HORIZON_MINUTES = 240;
+}
+
+// ============================================
+// KONFIGURASI OPTIMASI KOMPOSISI SLOT
+// ============================================
+
+namespace OptimizerConfig {
+    // Penalti per kendaraan yang ditolak karena penuh (Rp), dikurangkan
+    // dari pendapatan saat membandingkan layout
+    const double REJECTION_PENALTY = 5000.0;
+    
+    // Simulated annealing: jumlah putaran, kandidat per thread per putaran,
+    // suhu awal (pecahan dari skor awal) dan faktor pendinginan per putaran
+    const int ANNEAL_ROUNDS = 200;
+    const int CANDIDATES_PER_THREAD = 4;
+    const double INITIAL_TEMPERATURE = 0.02;
+    const double COOLING_RATE = 0.97;
+    
+    // Maksimum slot yang dipindah antar tipe dalam satu langkah
+    const int MAX_MOVE = 3;
+    // Setiap tipe slot dipertahankan minimal sebanyak ini
+    const int MIN_SLOTS_PER_KIND = 1;
+    const unsigned RANDOM_SEED = 42;
+    
+    // Jumlah hari riwayat pembayaran yang diputar ulang secara default
+    const int DEFAULT_HISTORY_DAYS = 28;
 }
 
 // ============================================
@@ -114,6 +329,7 @@ namespace Messages {
     const std::string ERROR_RESERVATION_FAILED = "Gagal melakukan reservasi slot VIP";
     const std::string ERROR_PAYMENT = "Terjadi kesalahan dalam proses pembayaran";
     const std::string ERROR_SLOT_OCCUPIED = "Slot sudah terisi";
+    const std::string ERROR_CLOSED = "Parkir sedang tutup, kendaraan tidak dapat masuk";
     
     // Pesan sukses
     const std::string SUCCESS_PARKED = "Kendaraan berhasil diparkir";
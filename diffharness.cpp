@@ -0,0 +1,280 @@
+// Differential harness: monolithic soalno3UAP.cpp against the modular lot.
+// Usage: diffharness [operations] [seed] [throughput operations]
+// Both implementations run the same random park/unpark/reserve workload on
+// a virtual clock. Every step must give the same ticket id, fee and error,
+// and the occupation and daily reports must match. Then each implementation
+// replays the workload alone and its throughput is printed.
+// Build: g++ -std=c++20 -O2 diffharness.cpp <modular sources except main.cpp,
+//        soalno3UAP.cpp, loadtestclient.cpp, staydriver.cpp and
+//        lotchecks.cpp> -o diffharness
+// The modular sources include extension.cpp, which defines the exceptions.
+#include "ParkingLot.h"
+#include "ParkingClock.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The reference copy is compiled into its own namespace. Its headers are
+// already included above, and its unqualified time(0) calls resolve to the
+// override below, so it reads the same virtual clock as the modular code.
+namespace reference {
+    inline time_t time(time_t*) { return ParkingClock::now(); }
+}
+#define main referenceMain
+namespace reference {
+#include "soalno3UAP.cpp"
+}
+#undef main
+
+typedef std::chrono::steady_clock Clock;
+
+struct Op {
+    enum Kind { PARK, UNPARK, UNPARK_INVALID, RESERVE, ADVANCE, REPORT };
+    Kind kind;
+    int vehicleType;   // PARK: 0 motorcycle, 1 car, 2 EV
+    bool charging;
+    std::string plate; // PARK, RESERVE
+    uint32_t pick;     // UNPARK: index into the live tickets
+    int hours;         // RESERVE
+    int64_t seconds;   // ADVANCE
+};
+
+struct Outcome {
+    enum Kind { OK, NO_SLOT, INVALID_TICKET, RESERVATION_FAILED, OTHER_ERROR };
+    Kind kind;
+    int ticketId;
+    double fee;
+    std::string report;
+    
+    bool operator==(const Outcome& other) const {
+        return kind == other.kind && ticketId == other.ticketId && fee == other.fee && report == other.report;
+    }
+};
+
+static std::vector<Op> makeWorkload(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Op> ops;
+    ops.reserve(count);
+    int plates = 0;
+    for (size_t i = 0; i < count; i++) {
+        Op op = { Op::ADVANCE, 0, false, "", 0, 0, 0 };
+        uint32_t roll = rng() % 100;
+        if (roll < 35) {
+            op.kind = Op::PARK;
+            op.vehicleType = rng() % 3;
+            op.charging = op.vehicleType == 2 && rng() % 2 == 0;
+            op.plate = "P" + std::to_string(plates++);
+        } else if (roll < 65) {
+            op.kind = Op::UNPARK;
+            op.pick = rng();
+        } else if (roll < 67) {
+            op.kind = Op::UNPARK_INVALID;
+        } else if (roll < 72) {
+            // Often for a plate that is about to arrive
+            op.kind = Op::RESERVE;
+            op.plate = "P" + std::to_string(plates + rng() % 4);
+            op.hours = 1 + rng() % 3;
+        } else if (roll < 97) {
+            // Mostly minutes, sometimes past a day for the long-term discount
+            op.seconds = rng() % 50 == 0 ? 20 * 3600 + rng() % (10 * 3600) : rng() % (3 * 3600);
+        } else {
+            op.kind = Op::REPORT;
+        }
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+// Drives one implementation; Lot, vehicle and exception types come from
+// the namespace the implementation lives in
+template <typename Lot, typename Motorcycle, typename Car, typename EV, typename Vehicle,
+          typename NoSlot, typename InvalidTicket, typename ReservationFailed, typename AnyError>
+class Runner {
+private:
+    Lot lot;
+    std::vector<int> live; // unpaid ticket ids, in issue order
+    
+    std::string captureReports() {
+        std::ostringstream out;
+        std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+        lot.showOccupation();
+        lot.generateDailyReport();
+        std::cout.rdbuf(saved);
+        return out.str();
+    }
+    
+public:
+    Lot& getLot() { return lot; }
+    
+    Outcome step(const Op& op) {
+        Outcome outcome = { Outcome::OK, 0, 0.0, "" };
+        try {
+            switch (op.kind) {
+                case Op::PARK: {
+                    std::shared_ptr<Vehicle> v;
+                    if (op.vehicleType == 0) v = std::make_shared<Motorcycle>(op.plate, "owner");
+                    else if (op.vehicleType == 1) v = std::make_shared<Car>(op.plate, "owner");
+                    else v = std::make_shared<EV>(op.plate, "owner", op.charging);
+                    outcome.ticketId = lot.parkVehicle(v)->getId();
+                    live.push_back(outcome.ticketId);
+                    break;
+                }
+                case Op::UNPARK: {
+                    if (live.empty()) break;
+                    size_t index = op.pick % live.size();
+                    outcome.ticketId = live[index];
+                    live.erase(live.begin() + index);
+                    outcome.fee = lot.unparkVehicle(outcome.ticketId);
+                    break;
+                }
+                case Op::UNPARK_INVALID:
+                    outcome.fee = lot.unparkVehicle(-1);
+                    break;
+                case Op::RESERVE:
+                    lot.reserveVIP(op.plate, op.hours);
+                    break;
+                case Op::REPORT:
+                    outcome.report = captureReports();
+                    break;
+                case Op::ADVANCE:
+                    break;
+            }
+        } catch (const NoSlot&) {
+            outcome.kind = Outcome::NO_SLOT;
+        } catch (const InvalidTicket&) {
+            outcome.kind = Outcome::INVALID_TICKET;
+        } catch (const ReservationFailed&) {
+            outcome.kind = Outcome::RESERVATION_FAILED;
+        } catch (const AnyError&) {
+            outcome.kind = Outcome::OTHER_ERROR;
+        }
+        return outcome;
+    }
+};
+
+typedef Runner<reference::ParkingLot, reference::Motorcycle, reference::Car, reference::EV, reference::Vehicle,
+               reference::NoAvailableSlotException, reference::InvalidTicketException,
+               reference::ReservationException, reference::ParkingException> ReferenceRunner;
+
+// The modular lot prepares the runner the way main.cpp does, minus the
+// features the reference does not have
+struct ModularLot : ParkingLot {
+    ModularLot() { setEnforceOperatingHours(false); }
+};
+
+typedef Runner<ModularLot, Motorcycle, Car, EV, Vehicle,
+               NoAvailableSlotException, InvalidTicketException,
+               ReservationException, ParkingException> ModularRunner;
+
+// Known, intended difference: the reference prints the slot id after
+// "Reserved for", the modular lot prints the reserved plate
+static std::string normalizeReport(const std::string& report) {
+    std::istringstream in(report);
+    std::string line, out;
+    const std::string marker = "Reserved for ";
+    while (std::getline(in, line)) {
+        size_t at = line.find(marker);
+        if (at != std::string::npos) line = line.substr(0, at + marker.size());
+        out += line + "\n";
+    }
+    return out;
+}
+
+static const char* kindName(Outcome::Kind kind) {
+    switch (kind) {
+        case Outcome::OK: return "ok";
+        case Outcome::NO_SLOT: return "no slot";
+        case Outcome::INVALID_TICKET: return "invalid ticket";
+        case Outcome::RESERVATION_FAILED: return "reservation failed";
+        default: return "error";
+    }
+}
+
+template <typename RunnerType>
+static double measure(const std::vector<Op>& ops, time_t start) {
+    VirtualClock clock(start);
+    RunnerType runner;
+    std::ostringstream sink; // reserveVIP prints; keep it off the terminal
+    std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+    auto began = Clock::now();
+    for (const Op& op : ops) {
+        if (op.kind == Op::ADVANCE) {
+            clock.set(clock.now() + op.seconds);
+        } else if (op.kind != Op::REPORT) {
+            runner.step(op);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - began).count();
+    std::cout.rdbuf(saved);
+    return ops.size() / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    unsigned seed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    size_t perfCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20000;
+    const time_t start = 1700000000;
+    
+    // Differential run: both lots in lockstep; ticket counters start equal
+    std::vector<Op> ops = makeWorkload(count, seed);
+    size_t mismatches = 0;
+    size_t outcomes[Outcome::OTHER_ERROR + 1] = {};
+    size_t reports = 0;
+    double revenue = 0;
+    {
+        VirtualClock clock(start);
+        ReferenceRunner expected;
+        ModularRunner actual;
+        for (size_t i = 0; i < ops.size() && mismatches < 10; i++) {
+            if (ops[i].kind == Op::ADVANCE) {
+                clock.set(clock.now() + ops[i].seconds);
+                continue;
+            }
+            std::ostringstream sink;
+            std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+            Outcome want = expected.step(ops[i]);
+            Outcome got = actual.step(ops[i]);
+            std::cout.rdbuf(saved);
+            outcomes[want.kind]++;
+            revenue += want.fee;
+            if (!want.report.empty()) reports++;
+            want.report = normalizeReport(want.report);
+            got.report = normalizeReport(got.report);
+            if (!(want == got)) {
+                mismatches++;
+                std::cout << "Mismatch at op " << i << ": reference " << kindName(want.kind)
+                          << " ticket " << want.ticketId << " fee " << std::fixed << std::setprecision(2) << want.fee
+                          << ", modular " << kindName(got.kind) << " ticket " << got.ticketId << " fee " << got.fee
+                          << std::endl;
+                if (want.report != got.report) {
+                    std::cout << "--- reference report" << want.report << "--- modular report" << got.report;
+                }
+            }
+        }
+    }
+    std::cout << "Differential run: " << ops.size() << " operations, seed " << seed << ", "
+              << mismatches << " mismatches" << std::endl;
+    std::cout << "  ok " << outcomes[Outcome::OK] << ", no slot " << outcomes[Outcome::NO_SLOT]
+              << ", invalid ticket " << outcomes[Outcome::INVALID_TICKET]
+              << ", reservation failed " << outcomes[Outcome::RESERVATION_FAILED]
+              << ", reports compared " << reports << ", fees Rp " << std::fixed << std::setprecision(2)
+              << revenue << std::endl;
+    
+    // Throughput: each implementation alone on a prefix of the workload.
+    // The reference finds tickets by linear scan, so keep this run shorter.
+    std::vector<Op> perfOps(ops.begin(), ops.begin() + std::min(perfCount, ops.size()));
+    double referenceRate = measure<ReferenceRunner>(perfOps, start);
+    double modularRate = measure<ModularRunner>(perfOps, start);
+    std::cout << std::fixed << std::setprecision(0)
+              << "Throughput (" << perfOps.size() << " operations): reference " << referenceRate
+              << " ops/s, modular " << modularRate << " ops/s" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#include "Exceptions.h"
+
+// Same messages as the reference implementation (soalno3UAP.cpp)
+ParkingException::ParkingException(const std::string& msg) : message(msg) {}
+
+const char* ParkingException::what() const noexcept {
+    return message.c_str();
+}
+
+ParkingException::~ParkingException() {}
+
+NoAvailableSlotException::NoAvailableSlotException()
+    : ParkingException("No available slot for this vehicle type") {}
+
+InvalidTicketException::InvalidTicketException()
+    : ParkingException("Invalid ticket ID") {}
+
+ReservationException::ReservationException()
+    : ParkingException("VIP slot reservation failed") {}
+
+PaymentException::PaymentException()
+    : ParkingException("Payment processing error") {}
@@ -0,0 +1,137 @@
+#include "FacilityRouter.h"
+#include <cmath>
+#include <limits>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// FacilityShard implementation
+FacilityShard::FacilityShard(int shardId, const std::string& facilityName, double x, double y, int core)
+    : name(facilityName), locationX(x), locationY(y), lot(shardId), stopping(false) {
+    for (int kind = 0; kind < 3; kind++) {
+        freeSlots[kind] = lot.availableSlots(static_cast<SlotKind>(kind));
+    }
+    lot.addObserver(this);
+    worker = std::thread(&FacilityShard::run, this, core);
+}
+
+FacilityShard::~FacilityShard() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    worker.join();
+}
+
+void FacilityShard::run(int core) {
+#ifdef __linux__
+    if (core >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+    std::deque<std::function<void()>> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping and drained
+            batch.swap(queue);
+        }
+        for (auto& task : batch) {
+            task();
+        }
+        batch.clear();
+    }
+}
+
+void FacilityShard::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    freeSlots[static_cast<int>(slot.getKind())].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void FacilityShard::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    freeSlots[static_cast<int>(slot.getKind())].fetch_add(1, std::memory_order_relaxed);
+}
+
+const std::string& FacilityShard::getName() const { return name; }
+
+double FacilityShard::distanceTo(double x, double y) const {
+    return std::hypot(locationX - x, locationY - y);
+}
+
+int FacilityShard::freeSlotCount(SlotKind kind) const {
+    return freeSlots[static_cast<int>(kind)].load(std::memory_order_relaxed);
+}
+
+// FacilityRouter implementation
+size_t FacilityRouter::addFacility(const std::string& name, double x, double y) {
+    if (byName.count(name)) {
+        throw ParkingException("Duplicate facility: " + name);
+    }
+    size_t index = shards.size();
+    unsigned cores = std::thread::hardware_concurrency();
+    int core = cores > 0 ? static_cast<int>(index % cores) : -1;
+    shards.push_back(std::make_unique<FacilityShard>(static_cast<int>(index), name, x, y, core));
+    byName[name] = index;
+    return index;
+}
+
+size_t FacilityRouter::facilityCount() const { return shards.size(); }
+
+int FacilityRouter::indexOf(const std::string& facility) const {
+    auto it = byName.find(facility);
+    return it == byName.end() ? -1 : static_cast<int>(it->second);
+}
+
+FacilityShard& FacilityRouter::shard(size_t index) {
+    return *shards.at(index);
+}
+
+FacilityShard& FacilityRouter::shardFor(const std::string& facility) {
+    auto it = byName.find(facility);
+    if (it == byName.end()) {
+        throw ParkingException("Unknown facility: " + facility);
+    }
+    return *shards[it->second];
+}
+
+std::future<std::shared_ptr<Ticket>> FacilityRouter::park(const std::string& facility, std::shared_ptr<Vehicle> v) {
+    return shardFor(facility).execute<std::shared_ptr<Ticket>>([v](ParkingLot& lot) {
+        return lot.parkVehicle(v);
+    });
+}
+
+std::future<double> FacilityRouter::unpark(int ticketId) {
+    int shard = ParkingLot::shardOfTicket(ticketId);
+    if (shard < 0 || static_cast<size_t>(shard) >= shards.size()) {
+        throw InvalidTicketException();
+    }
+    return shards[shard]->execute<double>([ticketId](ParkingLot& lot) {
+        return lot.unparkVehicle(ticketId);
+    });
+}
+
+std::future<void> FacilityRouter::reserveVIP(const std::string& facility, const std::string& plate, int durationHours) {
+    return shardFor(facility).execute<void>([plate, durationHours](ParkingLot& lot) {
+        lot.reserveVIP(plate, durationHours);
+    });
+}
+
+std::string FacilityRouter::nearestWithFree(SlotKind kind, double x, double y) const {
+    const FacilityShard* best = nullptr;
+    double bestDistance = std::numeric_limits<double>::max();
+    for (const auto& shard : shards) {
+        if (shard->freeSlotCount(kind) <= 0) continue;
+        double distance = shard->distanceTo(x, y);
+        if (distance < bestDistance) {
+            best = shard.get();
+            bestDistance = distance;
+        }
+    }
+    return best ? best->getName() : "";
+}
@@ -0,0 +1,91 @@
+#ifndef FACILITYROUTER_H
+#define FACILITYROUTER_H
+
+#include "ParkingLot.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One facility: a ParkingLot owned by a dedicated thread. All lot access
+// goes through the shard's queue, so the lot itself needs no locking.
+// Free-slot counters are published as atomics for lock-free routing.
+class FacilityShard : public ParkingObserver {
+private:
+    std::string name;
+    double locationX, locationY;
+    ParkingLot lot;
+    std::atomic<int> freeSlots[3]; // indexed by SlotKind
+    
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::function<void()>> queue;
+    bool stopping;
+    std::thread worker;
+    
+    void run(int core);
+    
+public:
+    FacilityShard(int shardId, const std::string& facilityName, double x, double y, int core);
+    ~FacilityShard();
+    
+    // Runs task on the shard thread; the future carries its result or exception
+    template <typename R>
+    std::future<R> execute(std::function<R(ParkingLot&)> task);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    const std::string& getName() const;
+    double distanceTo(double x, double y) const;
+    int freeSlotCount(SlotKind kind) const;
+};
+
+// Routes gate requests to facility shards. Parking goes by facility name,
+// exits go by the shard encoded in the ticket ID (O(1)), and availability
+// questions are answered from the shards' atomic counters without
+// touching any lot.
+class FacilityRouter {
+private:
+    std::vector<std::unique_ptr<FacilityShard>> shards;
+    std::map<std::string, size_t> byName;
+    
+    FacilityShard& shardFor(const std::string& facility);
+    
+public:
+    // Shards are pinned round-robin to the available cores. Throws once
+    // ParkingLot::maxShards() facilities exist.
+    size_t addFacility(const std::string& name, double x, double y);
+    size_t facilityCount() const;
+    // Index of the named facility, or -1
+    int indexOf(const std::string& facility) const;
+    FacilityShard& shard(size_t index);
+    
+    std::future<std::shared_ptr<Ticket>> park(const std::string& facility, std::shared_ptr<Vehicle> v);
+    std::future<double> unpark(int ticketId);
+    std::future<void> reserveVIP(const std::string& facility, const std::string& plate, int durationHours);
+    
+    // Nearest facility with at least one free slot of the kind, or "" if none
+    std::string nearestWithFree(SlotKind kind, double x, double y) const;
+};
+
+template <typename R>
+std::future<R> FacilityShard::execute(std::function<R(ParkingLot&)> task) {
+    auto packaged = std::make_shared<std::packaged_task<R()>>([this, task] { return task(lot); });
+    std::future<R> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back([packaged] { (*packaged)(); });
+    }
+    queueReady.notify_one();
+    return result;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef GATEPROTOCOL_H
+#define GATEPROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Compact binary protocol between gates and the gate server. All integers
+// are little-endian. Every frame starts with a fixed header:
+//   u32 payload length | u32 request id | u8 opcode (request) or status (response)
+// Requests may be pipelined; responses carry the request id they answer.
+//
+// Request payloads:
+//   PARK       u8 vehicleType, u8 charging, u8 attributes, str plate, str owner
+//              [f32 energyKWh, u16 stayMinutes]  optional charging request;
+//              0 or absent = ChargingConfig defaults
+//   UNPARK     i32 ticketId
+//   RESERVE    i32 hours, str plate
+//   OCCUPANCY  (empty)
+//   REPORT     (empty)
+//   FACILITY   str name   selects the facility for this connection's PARK,
+//                         RESERVE, OCCUPANCY and REPORT (multi-facility
+//                         servers only; the first facility until then).
+//                         UNPARK is routed by the shard in the ticket id.
+// Response payloads (status OK only):
+//   PARK       i32 ticketId, str slotId
+//   UNPARK     f64 fee
+//   OCCUPANCY  u32 free[3] (by SlotKind)
+//   REPORT     u64 vehicles[3] (by VehicleType), f64 revenue
+//   FACILITY   u32 facility index
+// str = u8 length + bytes.
+namespace GateProtocol {
+    const size_t HEADER_SIZE = 9;
+    const uint32_t MAX_PAYLOAD = 1024;
+    
+    enum Opcode : uint8_t { PARK = 1, UNPARK = 2, RESERVE = 3, OCCUPANCY = 4, REPORT = 5, FACILITY = 6 };
+    enum Status : uint8_t {
+        OK = 0, NO_SLOT = 1, INVALID_TICKET = 2, RESERVATION_FAILED = 3,
+        PAYMENT_FAILED = 4, ERROR = 5, BAD_REQUEST = 6, UNKNOWN_FACILITY = 7
+    };
+    
+    struct Frame {
+        uint32_t requestId;
+        uint8_t code;
+        const uint8_t* payload;
+        uint32_t length;
+    };
+    
+    // Appends a frame to out without intermediate buffers
+    class Writer {
+    private:
+        std::vector<uint8_t>& out;
+        size_t start;
+    public:
+        Writer(std::vector<uint8_t>& buffer, uint32_t requestId, uint8_t code)
+            : out(buffer), start(buffer.size()) {
+            out.resize(start + HEADER_SIZE);
+            std::memcpy(&out[start + 4], &requestId, 4);
+            out[start + 8] = code;
+        }
+        ~Writer() {
+            uint32_t length = static_cast<uint32_t>(out.size() - start - HEADER_SIZE);
+            std::memcpy(&out[start], &length, 4);
+        }
+        template <typename T>
+        Writer& put(T value) {
+            size_t at = out.size();
+            out.resize(at + sizeof(T));
+            std::memcpy(&out[at], &value, sizeof(T));
+            return *this;
+        }
+        Writer& putString(const std::string& s) {
+            uint8_t len = static_cast<uint8_t>(s.size() < 255 ? s.size() : 255);
+            out.push_back(len);
+            out.insert(out.end(), s.begin(), s.begin() + len);
+            return *this;
+        }
+    };
+    
+    // Bounds-checked reader over one payload; ok() turns false on underrun
+    class Reader {
+    private:
+        const uint8_t* data;
+        uint32_t length;
+        uint32_t pos;
+        bool valid;
+    public:
+        Reader(const uint8_t* payload, uint32_t len) : data(payload), length(len), pos(0), valid(true) {}
+        template <typename T>
+        T get() {
+            T value = T();
+            if (pos + sizeof(T) > length) { valid = false; return value; }
+            std::memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+        std::string getString() {
+            uint8_t len = get<uint8_t>();
+            if (!valid || pos + len > length) { valid = false; return std::string(); }
+            std::string s(reinterpret_cast<const char*>(data + pos), len);
+            pos += len;
+            return s;
+        }
+        bool ok() const { return valid; }
+        bool atEnd() const { return pos >= length; }
+    };
+    
+    // Parses one frame from [data, data + size). Returns bytes consumed,
+    // 0 if the frame is incomplete, or -1 if the header is invalid.
+    inline long parseFrame(const uint8_t* data, size_t size, Frame& frame) {
+        if (size < HEADER_SIZE) return 0;
+        std::memcpy(&frame.length, data, 4);
+        if (frame.length > MAX_PAYLOAD) return -1;
+        if (size < HEADER_SIZE + frame.length) return 0;
+        std::memcpy(&frame.requestId, data + 4, 4);
+        frame.code = data[8];
+        frame.payload = data + HEADER_SIZE;
+        return static_cast<long>(HEADER_SIZE + frame.length);
+    }
+}
+
+#endif
@@ -0,0 +1,470 @@
+#include "GateServer.h"
+#include "ConfigParking.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const int MAX_EVENTS = 256;
+    const size_t READ_CHUNK = 64 * 1024;
+    // Per wakeup, so one busy gate cannot starve the others; the loop is
+    // level-triggered and comes back for the rest
+    const size_t READ_BUDGET = 4 * READ_CHUNK;
+    // Unparsed bytes held per connection; always above one whole frame
+    const size_t MAX_BUFFERED_INPUT = 4 * READ_CHUNK;
+}
+
+GateServer::GateServer(ParkingLot& parkingLot, const std::string& address)
+    : lot(&parkingLot), router(nullptr), endpoint(address), listenFd(-1), epollFd(-1), running(false),
+      vehicleCounts{0, 0, 0}, revenue(0) {
+    for (int kind = 0; kind < 3; kind++) {
+        freeSlots[kind] = lot->availableSlots(static_cast<SlotKind>(kind));
+    }
+    lot->addObserver(this);
+}
+
+GateServer::GateServer(FacilityRouter& facilities, const std::string& address)
+    : lot(nullptr), router(&facilities), endpoint(address), listenFd(-1), epollFd(-1), running(false),
+      vehicleCounts{0, 0, 0}, revenue(0), freeSlots{0, 0, 0} {
+    if (router->facilityCount() == 0) {
+        throw ParkingException("Gate server needs at least one facility");
+    }
+}
+
+GateServer::~GateServer() {
+    if (lot) lot->removeObserver(this);
+#ifdef __linux__
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+    if (listenFd >= 0) ::close(listenFd);
+    if (epollFd >= 0) ::close(epollFd);
+    if (!endpoint.empty() && (endpoint[0] == '/' || endpoint[0] == '.')) {
+        ::unlink(endpoint.c_str());
+    }
+#endif
+}
+
+void GateServer::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    freeSlots[static_cast<int>(slot.getKind())]--;
+}
+
+void GateServer::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    freeSlots[static_cast<int>(slot.getKind())]++;
+    vehicleCounts[static_cast<int>(ticket.getVehicle()->getType())]++;
+    revenue += fee;
+}
+
+void GateServer::stop() {
+    running = false;
+}
+
+#ifdef __linux__
+
+int GateServer::bindListener(const std::string& endpoint) {
+    if (endpoint.empty()) {
+        throw ParkingException("Gate server address is empty");
+    }
+    int listenFd;
+    if (endpoint[0] == '/' || endpoint[0] == '.') {
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (endpoint.size() >= sizeof(addr.sun_path)) {
+            throw ParkingException("Socket path too long: " + endpoint);
+        }
+        std::memcpy(addr.sun_path, endpoint.c_str(), endpoint.size() + 1);
+        ::unlink(endpoint.c_str());
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            if (listenFd >= 0) ::close(listenFd);
+            throw ParkingException("Cannot bind " + endpoint);
+        }
+    } else {
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int one = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(std::atoi(endpoint.c_str())));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            if (listenFd >= 0) ::close(listenFd);
+            throw ParkingException("Cannot bind 127.0.0.1:" + endpoint);
+        }
+    }
+    if (::listen(listenFd, SOMAXCONN) < 0) {
+        ::close(listenFd);
+        throw ParkingException("Cannot listen on " + endpoint);
+    }
+    return listenFd;
+}
+
+void GateServer::listen() {
+    if (listenFd >= 0) return;
+    listenFd = bindListener(endpoint);
+    epollFd = ::epoll_create1(0);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+}
+
+void GateServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd < 0) return; // EAGAIN: backlog drained
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // fails harmlessly on AF_UNIX
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        Connection& conn = connections[fd];
+        conn.outputSent = 0;
+        conn.events = EPOLLIN;
+        conn.closing = false;
+        conn.facility = 0;
+    }
+}
+
+bool GateServer::readConnection(int fd) {
+    Connection& conn = connections[fd];
+    size_t budget = READ_BUDGET;
+    while (budget > 0 && conn.input.size() < MAX_BUFFERED_INPUT) {
+        size_t at = conn.input.size();
+        size_t chunk = std::min(std::min(READ_CHUNK, budget), MAX_BUFFERED_INPUT - at);
+        conn.input.resize(at + chunk);
+        ssize_t n = ::read(fd, conn.input.data() + at, chunk);
+        conn.input.resize(at + (n > 0 ? n : 0));
+        if (n > 0) {
+            budget -= n;
+            continue;
+        }
+        if (n == 0) {
+            // Half-closed: answer what was already sent, then close
+            conn.closing = true;
+            return true;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    return true;
+}
+
+size_t GateServer::parseFrames(int fd, Connection& conn, std::vector<Pending>& batch) {
+    size_t offset = 0;
+    while (true) {
+        GateProtocol::Frame frame;
+        long used = GateProtocol::parseFrame(conn.input.data() + offset, conn.input.size() - offset, frame);
+        if (used == 0) break;
+        if (used < 0) {
+            // Unrecoverable framing error: drop everything, reply once and
+            // close after the reply
+            GateProtocol::Writer(conn.output, 0, GateProtocol::BAD_REQUEST);
+            conn.closing = true;
+            return conn.input.size();
+        }
+        batch.push_back({fd, frame});
+        offset += used;
+    }
+    return offset;
+}
+
+void GateServer::execute(ParkingLot& target, const GateProtocol::Frame& frame, std::vector<uint8_t>& out) {
+    using namespace GateProtocol;
+    Reader in(frame.payload, frame.length);
+    
+    try {
+        switch (frame.code) {
+            case PARK: {
+                uint8_t type = in.get<uint8_t>();
+                bool chargingRequested = in.get<uint8_t>() != 0;
+                uint8_t attributes = in.get<uint8_t>();
+                std::string plate = in.getString();
+                std::string owner = in.getString();
+                float energy = 0;
+                uint16_t stayMinutes = 0;
+                if (!in.atEnd()) {
+                    energy = in.get<float>();
+                    stayMinutes = in.get<uint16_t>();
+                }
+                if (!in.ok() || type > 2 || !EV::validChargingRequest(energy, stayMinutes)) break;
+                std::shared_ptr<Vehicle> vehicle;
+                switch (static_cast<VehicleType>(type)) {
+                    case VehicleType::MOTORCYCLE: vehicle = std::make_shared<Motorcycle>(plate, owner); break;
+                    case VehicleType::CAR: vehicle = std::make_shared<Car>(plate, owner); break;
+                    case VehicleType::EV: {
+                        auto ev = std::make_shared<EV>(plate, owner, chargingRequested);
+                        ev->setChargingRequest(energy, stayMinutes);
+                        vehicle = ev;
+                        break;
+                    }
+                }
+                vehicle->setAttributes(attributes & VehicleAttribute::ALL);
+                auto ticket = target.parkVehicle(vehicle);
+                Writer(out, frame.requestId, OK).put<int32_t>(ticket->getId()).putString(ticket->getSlotId());
+                return;
+            }
+            case UNPARK: {
+                int32_t ticketId = in.get<int32_t>();
+                if (!in.ok()) break;
+                double fee = target.unparkVehicle(ticketId);
+                Writer(out, frame.requestId, OK).put<double>(fee);
+                return;
+            }
+            case RESERVE: {
+                int32_t hours = in.get<int32_t>();
+                std::string plate = in.getString();
+                if (!in.ok() || hours < ParkingLayout::MIN_VIP_RESERVATION_HOURS ||
+                    hours > ParkingLayout::MAX_VIP_RESERVATION_HOURS) break;
+                target.reserveVIP(plate, hours);
+                Writer(out, frame.requestId, OK);
+                return;
+            }
+        }
+        Writer(out, frame.requestId, BAD_REQUEST);
+    } catch (const NoAvailableSlotException&) {
+        Writer(out, frame.requestId, NO_SLOT);
+    } catch (const InvalidTicketException&) {
+        Writer(out, frame.requestId, INVALID_TICKET);
+    } catch (const ReservationException&) {
+        Writer(out, frame.requestId, RESERVATION_FAILED);
+    } catch (const PaymentException&) {
+        Writer(out, frame.requestId, PAYMENT_FAILED);
+    } catch (const std::exception&) {
+        Writer(out, frame.requestId, ERROR);
+    }
+}
+
+void GateServer::dispatch(const Pending& request) {
+    using namespace GateProtocol;
+    if (router) {
+        route(request);
+        return;
+    }
+    Connection& conn = connections[request.fd];
+    const Frame& frame = request.frame;
+    switch (frame.code) {
+        case OCCUPANCY: {
+            Writer out(conn.output, frame.requestId, OK);
+            for (int kind = 0; kind < 3; kind++) {
+                out.put<uint32_t>(static_cast<uint32_t>(freeSlots[kind]));
+            }
+            return;
+        }
+        case REPORT: {
+            Writer out(conn.output, frame.requestId, OK);
+            for (int type = 0; type < 3; type++) {
+                out.put<uint64_t>(vehicleCounts[type]);
+            }
+            out.put<double>(revenue);
+            return;
+        }
+        case FACILITY:
+            Writer(conn.output, frame.requestId, BAD_REQUEST);
+            return;
+        default:
+            execute(*lot, frame, conn.output);
+    }
+}
+
+void GateServer::route(const Pending& request) {
+    using namespace GateProtocol;
+    Connection& conn = connections[request.fd];
+    const Frame& frame = request.frame;
+    Reader in(frame.payload, frame.length);
+    size_t shard = conn.facility;
+    
+    switch (frame.code) {
+        case FACILITY: {
+            std::string name = in.getString();
+            int index = in.ok() ? router->indexOf(name) : -1;
+            if (index < 0) {
+                Writer(conn.output, frame.requestId, in.ok() ? UNKNOWN_FACILITY : BAD_REQUEST);
+                return;
+            }
+            conn.facility = static_cast<size_t>(index);
+            Writer(conn.output, frame.requestId, OK).put<uint32_t>(static_cast<uint32_t>(index));
+            return;
+        }
+        case OCCUPANCY: {
+            // Published atomics; no hop to the shard thread
+            Writer out(conn.output, frame.requestId, OK);
+            for (int kind = 0; kind < 3; kind++) {
+                int free = router->shard(shard).freeSlotCount(static_cast<SlotKind>(kind));
+                out.put<uint32_t>(static_cast<uint32_t>(free > 0 ? free : 0));
+            }
+            return;
+        }
+        case UNPARK: {
+            int32_t ticketId = in.get<int32_t>();
+            int owner = in.ok() ? ParkingLot::shardOfTicket(ticketId) : -1;
+            if (owner < 0 || static_cast<size_t>(owner) >= router->facilityCount()) {
+                Writer(conn.output, frame.requestId, in.ok() ? INVALID_TICKET : BAD_REQUEST);
+                return;
+            }
+            shard = static_cast<size_t>(owner);
+            break;
+        }
+        default:
+            break;
+    }
+    
+    // The shard thread gets its own copy of the frame; the input buffer is
+    // compacted once the batch is done
+    std::vector<uint8_t> payload(frame.payload, frame.payload + frame.length);
+    Frame copy = frame;
+    routed.push_back({ request.fd, router->shard(shard).execute<std::vector<uint8_t>>(
+        [copy, payload](ParkingLot& target) mutable {
+            std::vector<uint8_t> out;
+            copy.payload = payload.data();
+            if (copy.code == REPORT) {
+                LotTotals totals = target.snapshot()->getTotals();
+                Writer report(out, copy.requestId, OK);
+                for (int type = 0; type < 3; type++) {
+                    report.put<uint64_t>(static_cast<uint64_t>(totals.closedByType[type]));
+                }
+                report.put<double>(totals.revenue);
+            } else {
+                execute(target, copy, out);
+            }
+            return out;
+        }) });
+}
+
+bool GateServer::flush(int fd) {
+    Connection& conn = connections[fd];
+    while (conn.outputSent < conn.output.size()) {
+        // MSG_NOSIGNAL: a gate that went away must not raise SIGPIPE
+        ssize_t n = ::send(fd, conn.output.data() + conn.outputSent, conn.output.size() - conn.outputSent,
+                           MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.outputSent += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false; // EPIPE, ECONNRESET, ...
+    }
+    bool pendingOutput = conn.outputSent < conn.output.size();
+    if (!pendingOutput) {
+        conn.output.clear();
+        conn.outputSent = 0;
+        if (conn.closing) return false;
+    }
+    uint32_t events = (conn.closing ? 0u : static_cast<uint32_t>(EPOLLIN)) |
+                      (pendingOutput ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (events != conn.events) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        conn.events = events;
+    }
+    return true;
+}
+
+void GateServer::closeConnection(int fd) {
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void GateServer::run() {
+    listen();
+    running = true;
+    
+    epoll_event events[MAX_EVENTS];
+    std::vector<int> readable, closing;
+    std::vector<Pending> batch;
+    std::vector<std::pair<int, size_t>> consumed;
+    
+    while (running) {
+        int n = ::epoll_wait(epollFd, events, MAX_EVENTS, 100);
+        if (n < 0 && errno != EINTR) {
+            throw ParkingException("epoll_wait failed");
+        }
+        readable.clear();
+        closing.clear();
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            // A hang-up with unread input still gets that input answered
+            if ((events[i].events & EPOLLERR) ||
+                ((events[i].events & EPOLLHUP) && !(events[i].events & EPOLLIN))) {
+                closing.push_back(fd);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !flush(fd)) {
+                closing.push_back(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                if (readConnection(fd)) readable.push_back(fd);
+                else closing.push_back(fd);
+            }
+        }
+        
+        // Parse every complete frame first, then dispatch the whole batch
+        batch.clear();
+        consumed.clear();
+        for (int fd : readable) {
+            Connection& conn = connections[fd];
+            consumed.push_back({fd, parseFrames(fd, conn, batch)});
+        }
+        for (const Pending& request : batch) {
+            dispatch(request);
+        }
+        // Responses from facility shards; gates match them by request id
+        for (Routed& reply : routed) {
+            std::vector<uint8_t> bytes = reply.response.get();
+            std::vector<uint8_t>& output = connections[reply.fd].output;
+            output.insert(output.end(), bytes.begin(), bytes.end());
+        }
+        routed.clear();
+        for (const auto& entry : consumed) {
+            std::vector<uint8_t>& input = connections[entry.first].input;
+            input.erase(input.begin(), input.begin() + entry.second);
+            if (!flush(entry.first)) closing.push_back(entry.first);
+        }
+        for (int fd : closing) {
+            if (connections.count(fd)) closeConnection(fd);
+        }
+    }
+}
+
+#else
+
+int GateServer::bindListener(const std::string& endpoint) {
+    throw ParkingException("Gate server mode requires Linux (epoll)");
+}
+void GateServer::listen() {
+    throw ParkingException("Gate server mode requires Linux (epoll)");
+}
+void GateServer::acceptConnections() {}
+bool GateServer::readConnection(int fd) { return false; }
+size_t GateServer::parseFrames(int fd, Connection& conn, std::vector<Pending>& batch) { return 0; }
+void GateServer::dispatch(const Pending& request) {}
+void GateServer::route(const Pending& request) {}
+void GateServer::execute(ParkingLot& target, const GateProtocol::Frame& frame, std::vector<uint8_t>& out) {}
+bool GateServer::flush(int fd) { return false; }
+void GateServer::closeConnection(int fd) {}
+
+void GateServer::run() {
+    throw ParkingException("Gate server mode requires Linux (epoll)");
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef GATESERVER_H
+#define GATESERVER_H
+
+#include "ParkingLot.h"
+#include "FacilityRouter.h"
+#include "GateProtocol.h"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Serves park/unpark/reserve/occupancy/report requests from gates over a
+// Unix domain socket (path starting with '/' or '.') or loopback TCP
+// ("port"). A single epoll loop reads every ready connection, parses all
+// complete (possibly pipelined) frames, dispatches the whole batch into the
+// lot, and then flushes each connection's responses with one write.
+// Built on a FacilityRouter, the server manages several facilities: each
+// request of the batch runs on its facility's shard thread, the shards
+// work in parallel, and the loop collects the responses before flushing.
+class GateServer : public ParkingObserver {
+private:
+    struct Connection {
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent;
+        uint32_t events;  // epoll interest currently registered
+        bool closing;     // peer half-closed or sent garbage: close once output drains
+        size_t facility; // selected with FACILITY; multi-facility mode only
+    };
+    struct Pending {
+        int fd;
+        GateProtocol::Frame frame;
+    };
+    struct Routed {
+        int fd;
+        std::future<std::vector<uint8_t>> response;
+    };
+    
+    ParkingLot* lot;          // single-facility mode
+    FacilityRouter* router;   // multi-facility mode
+    std::vector<Routed> routed;
+    std::string endpoint;
+    int listenFd;
+    int epollFd;
+    std::atomic<bool> running;
+    std::unordered_map<int, Connection> connections;
+    
+    // Incremental report counters (REPORT never scans tickets)
+    uint64_t vehicleCounts[3];
+    double revenue;
+    int freeSlots[3];
+    
+    void acceptConnections();
+    bool readConnection(int fd);
+    size_t parseFrames(int fd, Connection& conn, std::vector<Pending>& batch);
+    void dispatch(const Pending& request);
+    void route(const Pending& request);
+    // PARK, UNPARK and RESERVE against one lot; the response goes to out
+    static void execute(ParkingLot& target, const GateProtocol::Frame& frame, std::vector<uint8_t>& out);
+    // Returns false once the connection should be closed
+    bool flush(int fd);
+    void closeConnection(int fd);
+    
+public:
+    GateServer(ParkingLot& parkingLot, const std::string& address);
+    GateServer(FacilityRouter& facilities, const std::string& address);
+    ~GateServer();
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    // Non-blocking socket listening on a socket path or loopback TCP port;
+    // throws ParkingException if it cannot be bound
+    static int bindListener(const std::string& endpoint);
+    
+    // Binds the endpoint; run() does it if not done yet
+    void listen();
+    void run();   // blocks until stop()
+    void stop();
+};
+
+#endif
@@ -0,0 +1,759 @@
+#include "GateSession.h"
+#include "GateServer.h"
+#include "ConfigParking.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// SessionTask implementation
+SessionTask SessionTask::promise_type::get_return_object() {
+    return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+std::coroutine_handle<> SessionTask::promise_type::FinalAwaiter::await_suspend(
+        std::coroutine_handle<promise_type> h) noexcept {
+    std::coroutine_handle<> next = h.promise().continuation;
+    return next ? next : std::noop_coroutine();
+}
+
+SessionTask::SessionTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+SessionTask::SessionTask(SessionTask&& other) noexcept : handle(other.handle) {
+    other.handle = nullptr;
+}
+
+SessionTask& SessionTask::operator=(SessionTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+SessionTask::~SessionTask() {
+    if (handle) handle.destroy();
+}
+
+bool SessionTask::done() const { return !handle || handle.done(); }
+std::coroutine_handle<> SessionTask::getHandle() const { return handle; }
+
+std::exception_ptr SessionTask::error() const {
+    return handle ? handle.promise().error : nullptr;
+}
+
+void SessionTask::runToCompletion() {
+    if (!handle) return;
+    if (!handle.done()) handle.resume();
+    if (!handle.done()) {
+        throw ParkingException("Dialog is waiting for input on a blocking terminal");
+    }
+    await_resume();
+}
+
+bool SessionTask::await_ready() const noexcept { return done(); }
+
+std::coroutine_handle<> SessionTask::await_suspend(std::coroutine_handle<> caller) noexcept {
+    handle.promise().continuation = caller;
+    return handle;
+}
+
+void SessionTask::await_resume() {
+    if (handle && handle.promise().error) {
+        std::rethrow_exception(handle.promise().error);
+    }
+}
+
+// Terminal implementation
+bool Terminal::LineAwaiter::await_ready() {
+    return terminal.lineReady();
+}
+
+bool Terminal::LineAwaiter::await_suspend(std::coroutine_handle<> h) {
+    return terminal.waitForLine(h);
+}
+
+std::optional<std::string> Terminal::LineAwaiter::await_resume() {
+    return terminal.takeLine();
+}
+
+Terminal::LineAwaiter Terminal::readLine() {
+    return LineAwaiter{*this};
+}
+
+void ConsoleTerminal::write(const std::string& text) {
+    std::cout << text;
+    std::cout.flush();
+}
+
+bool ConsoleTerminal::lineReady() {
+    return true; // takeLine blocks
+}
+
+bool ConsoleTerminal::waitForLine(std::coroutine_handle<> h) {
+    return false;
+}
+
+std::optional<std::string> ConsoleTerminal::takeLine() {
+    std::string line;
+    if (!std::getline(std::cin, line)) return std::nullopt;
+    return line;
+}
+
+// TerminalSession implementation
+TerminalSession::TerminalSession(int sessionId, SessionScheduler& owner)
+    : id(sessionId), scheduler(owner), closed(false) {}
+
+bool TerminalSession::lineReady() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !lines.empty() || closed;
+}
+
+bool TerminalSession::waitForLine(std::coroutine_handle<> h) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!lines.empty() || closed) {
+        return false; // input arrived meanwhile, keep running
+    }
+    waiter = h;
+    return true;
+}
+
+std::optional<std::string> TerminalSession::takeLine() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (lines.empty()) return std::nullopt;
+    std::string line = std::move(lines.front());
+    lines.pop_front();
+    return line;
+}
+
+void TerminalSession::write(const std::string& text) {
+    scheduler.emit(id, text);
+}
+
+int TerminalSession::getId() const { return id; }
+
+// SessionScheduler implementation
+SessionScheduler::SessionScheduler(ParkingLot& parkingLot, const MemberRegistry* members, size_t threadCount,
+                                   OutputSink output, EndSink end)
+    : context{parkingLot, lotMutex, members, nullptr, false}, sink(output), ended(end),
+      nextSessionId(1), stopping(false) {
+    if (threadCount == 0) threadCount = 1;
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { workerLoop(*w); });
+    }
+}
+
+SessionScheduler::~SessionScheduler() {
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            stopping = true;
+        }
+        worker->ready.notify_one();
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+    // Suspended coroutine frames are destroyed with their sessions
+    sessions.clear();
+}
+
+void SessionScheduler::workerLoop(Worker& worker) {
+    while (true) {
+        std::pair<TerminalSession*, std::coroutine_handle<>> next;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.ready.wait(lock, [&] { return stopping || !worker.queue.empty(); });
+            if (worker.queue.empty()) return;
+            next = worker.queue.front();
+            worker.queue.pop_front();
+        }
+        next.second.resume();
+        TerminalSession* session = next.first;
+        if (!session->root || !session->root->done()) continue;
+        
+        // A dialog that threw ends its session; say why on both ends
+        if (std::exception_ptr error = session->root->error()) {
+            std::string reason = "unknown error";
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                reason = e.what();
+            } catch (...) {
+            }
+            std::cerr << "Terminal session " << session->id << " failed: " << reason << std::endl;
+            emit(session->id, "Session error: " + reason + "\n");
+        }
+        finishSession(session);
+    }
+}
+
+void SessionScheduler::finishSession(TerminalSession* session) {
+    int id = session->id;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        sessions.erase(id);
+    }
+    if (ended) ended(id);
+}
+
+void SessionScheduler::schedule(TerminalSession* session, std::coroutine_handle<> h) {
+    Worker& worker = *workers[static_cast<size_t>(session->id) % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queue.push_back({session, h});
+    }
+    worker.ready.notify_one();
+}
+
+int SessionScheduler::openSession() {
+    TerminalSession* session;
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        id = nextSessionId++;
+        auto created = std::make_unique<TerminalSession>(id, *this);
+        session = created.get();
+        session->root.emplace(GateDialogs::runGateSession(*session, context));
+        sessions[id] = std::move(created);
+    }
+    schedule(session, session->root->getHandle());
+    return id;
+}
+
+bool SessionScheduler::deliver(int sessionId, const std::string& line) {
+    std::lock_guard<std::mutex> registry(sessionsMutex);
+    auto it = sessions.find(sessionId);
+    if (it == sessions.end()) return false;
+    TerminalSession* session = it->second.get();
+    
+    std::coroutine_handle<> resume;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->closed || session->lines.size() >= SystemConfig::TERMINAL_MAX_PENDING_LINES) {
+            return false;
+        }
+        session->lines.push_back(line);
+        resume = session->waiter;
+        session->waiter = nullptr;
+    }
+    if (resume) schedule(session, resume);
+    return true;
+}
+
+void SessionScheduler::closeSession(int sessionId) {
+    std::lock_guard<std::mutex> registry(sessionsMutex);
+    auto it = sessions.find(sessionId);
+    if (it == sessions.end()) return;
+    TerminalSession* session = it->second.get();
+    
+    std::coroutine_handle<> resume;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->closed = true;
+        resume = session->waiter;
+        session->waiter = nullptr;
+    }
+    // Queued lines are still answered, then readLine() returns empty and
+    // the dialog unwinds
+    if (resume) schedule(session, resume);
+}
+
+size_t SessionScheduler::activeSessions() {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    return sessions.size();
+}
+
+void SessionScheduler::emit(int sessionId, const std::string& text) {
+    if (sink) sink(sessionId, text);
+}
+
+std::mutex& SessionScheduler::getLotMutex() { return lotMutex; }
+
+// Gate dialogs
+namespace {
+    bool parseInt(const std::string& line, int& value) {
+        char* end = nullptr;
+        long parsed = std::strtol(line.c_str(), &end, 10);
+        if (end == line.c_str()) return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+    
+    bool parseDouble(const std::string& line, double& value) {
+        char* end = nullptr;
+        double parsed = std::strtod(line.c_str(), &end);
+        if (end == line.c_str()) return false;
+        value = parsed;
+        return true;
+    }
+    
+    std::string formatAmount(double amount) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.2f", amount);
+        return text;
+    }
+    
+    std::string formatNumber(double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%g", value);
+        return text;
+    }
+}
+
+SessionTask GateDialogs::registerAndPark(Terminal& term, GateDialogContext& context) {
+    term.write("\nEnter vehicle plate: ");
+    auto plate = co_await term.readLine();
+    if (!plate) co_return;
+    std::string owner = context.members ? context.members->memberName(*plate) : "";
+    if (!owner.empty()) {
+        term.write("Welcome back, " + owner + " (member)\n");
+    } else {
+        term.write("Enter owner name: ");
+        auto name = co_await term.readLine();
+        if (!name) co_return;
+        owner = *name;
+    }
+    
+    term.write("Vehicle type:\n1. Motorcycle\n2. Car\n3. EV\nChoice: ");
+    auto line = co_await term.readLine();
+    if (!line) co_return;
+    int typeChoice = 0;
+    parseInt(*line, typeChoice);
+    
+    std::shared_ptr<Vehicle> vehicle;
+    switch(typeChoice) {
+        case 1:
+            vehicle = std::make_shared<Motorcycle>(*plate, owner);
+            break;
+        case 2:
+            vehicle = std::make_shared<Car>(*plate, owner);
+            break;
+        case 3: {
+            term.write("Need charging? (1=Yes, 0=No): ");
+            line = co_await term.readLine();
+            if (!line) co_return;
+            int chargeChoice = 0;
+            parseInt(*line, chargeChoice);
+            auto ev = std::make_shared<EV>(*plate, owner, chargeChoice == 1);
+            if (chargeChoice == 1) {
+                double energy = 0;
+                double stayHours = 0;
+                term.write("Energy needed in kWh (0 = " +
+                           formatNumber(ChargingConfig::DEFAULT_ENERGY_REQUEST_KWH) + "): ");
+                line = co_await term.readLine();
+                if (!line) co_return;
+                parseDouble(*line, energy);
+                term.write("Leaving in how many hours (0 = " +
+                           formatNumber(ChargingConfig::DEFAULT_STAY_HOURS) + "): ");
+                line = co_await term.readLine();
+                if (!line) co_return;
+                parseDouble(*line, stayHours);
+                if (!EV::validChargingRequest(energy, stayHours * 60)) {
+                    term.write("Invalid charging request! Up to " +
+                               formatNumber(ChargingConfig::MAX_ENERGY_REQUEST_KWH) + " kWh and " +
+                               std::to_string(ChargingConfig::MAX_STAY_HOURS) + " hours.\n");
+                    co_return;
+                }
+                ev->setChargingRequest(energy, static_cast<int>(stayHours * 60));
+            }
+            vehicle = ev;
+            break;
+        }
+        default:
+            term.write("Invalid choice!\n");
+            co_return;
+    }
+    
+    term.write("Special requirements (0=None, 1=Height over 2.0m, 2=Oversized, 4=Accessibility; "
+               "add to combine): ");
+    line = co_await term.readLine();
+    if (!line) co_return;
+    int requirements = 0;
+    parseInt(*line, requirements);
+    vehicle->setAttributes(static_cast<unsigned>(requirements) & VehicleAttribute::ALL);
+    
+    try {
+        ParkingLot::Admission admission;
+        {
+            std::lock_guard<std::mutex> lock(context.lotMutex);
+            admission = context.lot.parkOrWait(vehicle);
+        }
+        if (!admission.ticket) {
+            term.write("Parking is full. Vehicle added to the waitlist.\nWait number: " +
+                       std::to_string(admission.waitId) + "\n");
+        } else {
+            term.write("Vehicle parked successfully!\nTicket ID: " +
+                       std::to_string(admission.ticket->getId()) + "\n");
+        }
+    } catch (const ParkingException& e) {
+        term.write(std::string("Error: ") + e.what() + "\n");
+    }
+}
+
+SessionTask GateDialogs::unparkVehicle(Terminal& term, GateDialogContext& context) {
+    term.write("\nEnter ticket ID: ");
+    auto line = co_await term.readLine();
+    if (!line) co_return;
+    int ticketId = 0;
+    if (!parseInt(*line, ticketId)) {
+        term.write("Invalid ticket ID!\n");
+        co_return;
+    }
+    
+    bool card = false;
+    if (context.payments) {
+        term.write("Payment method (1=Cash, 2=Debit/Credit): ");
+        line = co_await term.readLine();
+        if (!line) co_return;
+        int methodChoice = 0;
+        parseInt(*line, methodChoice);
+        card = (methodChoice == 2);
+    }
+    
+    try {
+        double fee;
+        {
+            std::lock_guard<std::mutex> lock(context.lotMutex);
+            if (context.payments) {
+                context.payments->setMethod(ticketId, card ? PaymentMethod::CARD : PaymentMethod::CASH);
+            }
+            try {
+                fee = context.lot.unparkVehicle(ticketId);
+            } catch (...) {
+                // The choice applies to this exit only
+                if (context.payments) context.payments->clearMethod(ticketId);
+                throw;
+            }
+        }
+        term.write("Vehicle unparked successfully!\nTotal fee: Rp " + formatAmount(fee) + "\n");
+        if (card) {
+            term.write("Card payment queued for processing.\n");
+        }
+    } catch (const InvalidTicketException& e) {
+        term.write(std::string("Error: ") + e.what() + "\n");
+        if (context.offerPlateSearch) {
+            term.write("Lost ticket? Use \"Find ticket by plate\" from the menu.\n");
+        }
+    } catch (const ParkingException& e) {
+        term.write(std::string("Error: ") + e.what() + "\n");
+    }
+}
+
+SessionTask GateDialogs::reserveVIP(Terminal& term, GateDialogContext& context) {
+    term.write("\nEnter vehicle plate for reservation: ");
+    auto plate = co_await term.readLine();
+    if (!plate) co_return;
+    term.write("Enter reservation duration (hours): ");
+    auto line = co_await term.readLine();
+    if (!line) co_return;
+    int duration = 0;
+    if (!parseInt(*line, duration) || duration < ParkingLayout::MIN_VIP_RESERVATION_HOURS ||
+        duration > ParkingLayout::MAX_VIP_RESERVATION_HOURS) {
+        term.write("Reservation must be " + std::to_string(ParkingLayout::MIN_VIP_RESERVATION_HOURS) + " to " +
+                   std::to_string(ParkingLayout::MAX_VIP_RESERVATION_HOURS) + " hours\n");
+        co_return;
+    }
+    
+    try {
+        {
+            std::lock_guard<std::mutex> lock(context.lotMutex);
+            context.lot.reserveVIP(*plate, duration);
+        }
+        term.write("Reservation confirmed for " + *plate + "\n");
+    } catch (const ParkingException& e) {
+        term.write(std::string("Error: ") + e.what() + "\n");
+    }
+}
+
+SessionTask GateDialogs::runGateSession(Terminal& term, GateDialogContext& context) {
+    int choice = -1;
+    do {
+        term.write("\n=== Gate Terminal ===\n1. Register vehicle and park\n2. Unpark vehicle\n"
+                   "3. Reserve VIP slot\n4. Show current occupation\n0. Exit\nChoice: ");
+        auto line = co_await term.readLine();
+        if (!line) {
+            co_return; // terminal closed
+        }
+        if (!parseInt(*line, choice)) {
+            choice = -1;
+        }
+        switch(choice) {
+            case 1:
+                co_await registerAndPark(term, context);
+                break;
+            case 2:
+                co_await unparkVehicle(term, context);
+                break;
+            case 3:
+                co_await reserveVIP(term, context);
+                break;
+            case 4: {
+                // Published snapshot: no lotMutex, never waits for a gate
+                std::ostringstream out;
+                context.lot.snapshot()->printOccupation(out);
+                term.write(out.str());
+                break;
+            }
+            case 0:
+                term.write("Goodbye!\n");
+                break;
+            default:
+                term.write("Invalid choice!\n");
+        }
+    } while (choice != 0);
+}
+
+// TerminalServer implementation
+TerminalServer::TerminalServer(ParkingLot& parkingLot, const MemberRegistry* members, const std::string& address,
+                               size_t threadCount)
+    : endpoint(address), listenFd(-1), epollFd(-1), wakeFd(-1), running(false) {
+    scheduler.reset(new SessionScheduler(parkingLot, members, threadCount,
+        [this](int sessionId, const std::string& text) { post(sessionId, text); },
+        [this](int sessionId) { sessionEnded(sessionId); }));
+}
+
+TerminalServer::~TerminalServer() {
+    // Workers post into this object; stop them first
+    scheduler.reset();
+#ifdef __linux__
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+    if (listenFd >= 0) ::close(listenFd);
+    if (epollFd >= 0) ::close(epollFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (!endpoint.empty() && (endpoint[0] == '/' || endpoint[0] == '.')) {
+        ::unlink(endpoint.c_str());
+    }
+#endif
+}
+
+void TerminalServer::stop() {
+    running = false;
+}
+
+void TerminalServer::post(int sessionId, const std::string& text) {
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        outbox[sessionId] += text;
+    }
+    wake();
+}
+
+void TerminalServer::sessionEnded(int sessionId) {
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        finished.insert(sessionId);
+    }
+    wake();
+}
+
+#ifdef __linux__
+
+void TerminalServer::wake() {
+    uint64_t one = 1;
+    if (::write(wakeFd, &one, sizeof(one)) < 0) {
+        // Counter saturated: the loop is already due to wake up
+    }
+}
+
+void TerminalServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd < 0) return; // EAGAIN: backlog drained
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        Connection& conn = connections[fd];
+        conn.outputSent = 0;
+        conn.events = EPOLLIN;
+        conn.inputClosed = false;
+        conn.closing = false;
+        conn.sessionId = scheduler->openSession();
+        sessionFds[conn.sessionId] = fd;
+    }
+}
+
+bool TerminalServer::readConnection(int fd, Connection& conn) {
+    char buffer[4096];
+    ssize_t n = ::read(fd, buffer, sizeof(buffer));
+    if (n == 0) {
+        // Input finished: queued lines are still answered, then the
+        // session ends and the connection closes
+        scheduler->closeSession(conn.sessionId);
+        conn.inputClosed = true;
+        return flush(fd, conn);
+    }
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    conn.input.append(buffer, static_cast<size_t>(n));
+    size_t start = 0;
+    size_t end;
+    while ((end = conn.input.find('\n', start)) != std::string::npos) {
+        std::string line = conn.input.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!scheduler->deliver(conn.sessionId, line)) {
+            return false; // input queue full
+        }
+        start = end + 1;
+    }
+    conn.input.erase(0, start);
+    return conn.input.size() <= SystemConfig::TERMINAL_MAX_LINE_LENGTH;
+}
+
+void TerminalServer::collectOutput() {
+    std::unordered_map<int, std::string> ready;
+    std::unordered_set<int> ended;
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        ready.swap(outbox);
+        ended.swap(finished);
+    }
+    std::vector<int> touched;
+    for (auto& entry : ready) {
+        auto fd = sessionFds.find(entry.first);
+        if (fd == sessionFds.end()) continue; // connection already gone
+        connections[fd->second].output += entry.second;
+        touched.push_back(fd->second);
+    }
+    for (int sessionId : ended) {
+        auto fd = sessionFds.find(sessionId);
+        if (fd == sessionFds.end()) continue;
+        connections[fd->second].closing = true;
+        touched.push_back(fd->second);
+    }
+    for (int fd : touched) {
+        auto conn = connections.find(fd);
+        if (conn != connections.end() && !flush(fd, conn->second)) {
+            closeConnection(fd);
+        }
+    }
+}
+
+bool TerminalServer::flush(int fd, Connection& conn) {
+    while (conn.outputSent < conn.output.size()) {
+        ssize_t n = ::send(fd, conn.output.data() + conn.outputSent, conn.output.size() - conn.outputSent,
+                           MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.outputSent += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    bool pendingOutput = conn.outputSent < conn.output.size();
+    if (!pendingOutput) {
+        conn.output.clear();
+        conn.outputSent = 0;
+        if (conn.closing) return false;
+    } else if (conn.output.size() - conn.outputSent > SystemConfig::TERMINAL_MAX_OUTPUT_BYTES) {
+        return false; // the terminal stopped reading
+    }
+    uint32_t events = (conn.inputClosed ? 0u : static_cast<uint32_t>(EPOLLIN)) |
+                      (pendingOutput ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (events != conn.events) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        conn.events = events;
+    }
+    return true;
+}
+
+void TerminalServer::closeConnection(int fd) {
+    auto conn = connections.find(fd);
+    if (conn == connections.end()) return;
+    scheduler->closeSession(conn->second.sessionId);
+    sessionFds.erase(conn->second.sessionId);
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(conn);
+}
+
+void TerminalServer::listen() {
+    if (listenFd >= 0) return;
+    listenFd = GateServer::bindListener(endpoint);
+    epollFd = ::epoll_create1(0);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) {
+        throw ParkingException("Cannot set up the terminal server loop");
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+}
+
+void TerminalServer::run() {
+    listen();
+    running = true;
+    
+    epoll_event events[64];
+    while (running) {
+        int n = ::epoll_wait(epollFd, events, 64, 100);
+        if (n < 0 && errno != EINTR) {
+            throw ParkingException("epoll_wait failed");
+        }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            if (fd == wakeFd) {
+                uint64_t count;
+                if (::read(wakeFd, &count, sizeof(count)) < 0) {
+                    // Already drained
+                }
+                continue;
+            }
+            auto conn = connections.find(fd);
+            if (conn == connections.end()) continue;
+            bool keep = !(events[i].events & EPOLLERR) &&
+                        (!(events[i].events & EPOLLHUP) || (events[i].events & EPOLLIN));
+            if (keep && (events[i].events & EPOLLOUT)) keep = flush(fd, conn->second);
+            if (keep && (events[i].events & EPOLLIN)) keep = readConnection(fd, conn->second);
+            if (!keep) closeConnection(fd);
+        }
+        collectOutput();
+    }
+}
+
+#else
+
+void TerminalServer::wake() {}
+void TerminalServer::acceptConnections() {}
+bool TerminalServer::readConnection(int fd, Connection& conn) { return false; }
+void TerminalServer::collectOutput() {}
+bool TerminalServer::flush(int fd, Connection& conn) { return false; }
+void TerminalServer::closeConnection(int fd) {}
+
+void TerminalServer::listen() {
+    throw ParkingException("Terminal server mode requires Linux (epoll)");
+}
+
+void TerminalServer::run() {
+    listen();
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef GATESESSION_H
+#define GATESESSION_H
+
+// Coroutine-based gate dialogs and terminal sessions. Requires C++20
+// (-std=c++20). The console UI runs the same dialogs on a blocking
+// terminal; TerminalServer multiplexes line-based socket terminals.
+
+#include "ParkingLot.h"
+#include "MemberRegistry.h"
+#include "PaymentPipeline.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Lazily started coroutine that can be co_awaited by another SessionTask,
+// so dialogs can be split into sub-dialogs like ordinary functions.
+class SessionTask {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+        
+        SessionTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit SessionTask(std::coroutine_handle<promise_type> h);
+    SessionTask(SessionTask&& other) noexcept;
+    SessionTask& operator=(SessionTask&& other) noexcept;
+    SessionTask(const SessionTask&) = delete;
+    SessionTask& operator=(const SessionTask&) = delete;
+    ~SessionTask();
+    
+    bool done() const;
+    std::coroutine_handle<> getHandle() const;
+    // Exception that ended the coroutine, if any
+    std::exception_ptr error() const;
+    
+    // Runs the task on the calling thread; for terminals that never suspend.
+    // Rethrows what the task threw.
+    void runToCompletion();
+    
+    bool await_ready() const noexcept;
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept;
+    void await_resume();
+};
+
+// Line-based input/output a dialog talks to
+class Terminal {
+public:
+    struct LineAwaiter {
+        Terminal& terminal;
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> h);
+        std::optional<std::string> await_resume();
+    };
+    
+    virtual ~Terminal() {}
+    
+    // Suspends until a line arrives; empty optional once the terminal closed
+    LineAwaiter readLine();
+    virtual void write(const std::string& text) = 0;
+
+protected:
+    virtual bool lineReady() = 0;
+    // Parks h until input arrives; false if it arrived meanwhile
+    virtual bool waitForLine(std::coroutine_handle<> h) = 0;
+    virtual std::optional<std::string> takeLine() = 0;
+};
+
+// std::cin/std::cout; reads block, so dialogs never suspend on it
+class ConsoleTerminal : public Terminal {
+public:
+    void write(const std::string& text) override;
+
+protected:
+    bool lineReady() override;
+    bool waitForLine(std::coroutine_handle<> h) override;
+    std::optional<std::string> takeLine() override;
+};
+
+// What the gate dialogs act on. Lot calls are made under lotMutex; members
+// and payments are optional.
+struct GateDialogContext {
+    ParkingLot& lot;
+    std::mutex& lotMutex;
+    const MemberRegistry* members;
+    PaymentPipeline* payments;  // asks for the payment method when set
+    bool offerPlateSearch;      // the terminal has "Find ticket by plate"
+};
+
+// The park, unpark and VIP reservation dialogs, shared by the console UI
+// and the terminal sessions
+namespace GateDialogs {
+    SessionTask registerAndPark(Terminal& term, GateDialogContext& context);
+    SessionTask unparkVehicle(Terminal& term, GateDialogContext& context);
+    SessionTask reserveVIP(Terminal& term, GateDialogContext& context);
+    // Gate terminal menu looping over the dialogs until "0" or close
+    SessionTask runGateSession(Terminal& term, GateDialogContext& context);
+}
+
+class SessionScheduler;
+
+// One operator terminal. Input lines are queued (bounded) and handed to the
+// session coroutine through co_await readLine(); output goes to the sink.
+class TerminalSession : public Terminal {
+    friend class SessionScheduler;
+private:
+    int id;
+    SessionScheduler& scheduler;
+    std::mutex mutex;
+    std::deque<std::string> lines;
+    std::coroutine_handle<> waiter;
+    bool closed;
+    std::optional<SessionTask> root;
+
+protected:
+    bool lineReady() override;
+    bool waitForLine(std::coroutine_handle<> h) override;
+    std::optional<std::string> takeLine() override;
+
+public:
+    TerminalSession(int sessionId, SessionScheduler& owner);
+    
+    void write(const std::string& text) override;
+    int getId() const;
+};
+
+// Runs thousands of terminal sessions on a few threads. Each session is
+// pinned to one worker; a session only occupies a thread while it has input
+// to process. ParkingLot calls are serialized through lotMutex.
+class SessionScheduler {
+public:
+    typedef std::function<void(int sessionId, const std::string& text)> OutputSink;
+    // Called once the session's dialog has returned
+    typedef std::function<void(int sessionId)> EndSink;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<std::pair<TerminalSession*, std::coroutine_handle<>>> queue;
+        std::thread thread;
+    };
+    
+    std::mutex lotMutex;
+    GateDialogContext context;
+    OutputSink sink;
+    EndSink ended;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex sessionsMutex;
+    std::unordered_map<int, std::unique_ptr<TerminalSession>> sessions;
+    int nextSessionId;
+    bool stopping;
+    
+    void workerLoop(Worker& worker);
+    void finishSession(TerminalSession* session);
+
+public:
+    SessionScheduler(ParkingLot& parkingLot, const MemberRegistry* members, size_t threadCount,
+                     OutputSink output, EndSink end = nullptr);
+    ~SessionScheduler();
+    
+    int openSession();
+    // Queues one input line; false if the session is unknown or its queue is full
+    bool deliver(int sessionId, const std::string& line);
+    void closeSession(int sessionId);
+    size_t activeSessions();
+    
+    void schedule(TerminalSession* session, std::coroutine_handle<> h);
+    void emit(int sessionId, const std::string& text);
+    std::mutex& getLotMutex();
+};
+
+// Line-based operator terminals over a Unix domain socket or loopback TCP
+// (same endpoint syntax as GateServer). Each connection is one session of
+// the scheduler: input lines are delivered to it and its output is written
+// back by the epoll loop, which workers wake through an eventfd. A terminal
+// that floods input, sends over-long lines or stops reading is closed, so
+// every session stays within a fixed amount of memory.
+class TerminalServer {
+private:
+    struct Connection {
+        int sessionId;
+        std::string input;
+        std::string output;
+        size_t outputSent;
+        uint32_t events;  // epoll interest currently registered
+        bool inputClosed; // peer finished sending
+        bool closing;     // session ended: close once output drains
+    };
+    
+    std::unique_ptr<SessionScheduler> scheduler;
+    std::string endpoint;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    std::atomic<bool> running;
+    std::unordered_map<int, Connection> connections;
+    std::unordered_map<int, int> sessionFds;
+    
+    // Filled by worker threads, drained by the loop
+    std::mutex outboxMutex;
+    std::unordered_map<int, std::string> outbox;
+    std::unordered_set<int> finished;
+    
+    void post(int sessionId, const std::string& text);
+    void sessionEnded(int sessionId);
+    void wake();
+    void acceptConnections();
+    bool readConnection(int fd, Connection& conn);
+    void collectOutput();
+    bool flush(int fd, Connection& conn);
+    void closeConnection(int fd);
+
+public:
+    TerminalServer(ParkingLot& parkingLot, const MemberRegistry* members, const std::string& address,
+                   size_t threadCount);
+    ~TerminalServer();
+    
+    // Binds the endpoint; run() does it if not done yet
+    void listen();
+    void run();   // blocks until stop()
+    void stop();
+};
+
+#endif
@@ -0,0 +1,185 @@
+// Load generator for the gate server.
+// Usage: loadtest <socket path | tcp port> [gates] [requests per gate] [pipeline depth]
+// Each simulated gate keeps up to `depth` requests in flight: a park, and
+// for every ticket it gets back an unpark, interleaved with occupancy
+// queries. Prints throughput and latency percentiles.
+#include "GateProtocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+struct Gate {
+    int fd;
+    int sent;
+    int inFlight;
+    std::vector<int32_t> ticketsToReturn;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+};
+
+static int connectTo(const std::string& endpoint) {
+    int fd;
+    if (endpoint[0] == '/' || endpoint[0] == '.') {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, endpoint.c_str(), sizeof(addr.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return -1;
+    } else {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(std::atoi(endpoint.c_str())));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return -1;
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <socket path | tcp port> [gates] [requests per gate] [pipeline depth]" << std::endl;
+        return 1;
+    }
+    std::string endpoint = argv[1];
+    int gateCount = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int perGate = argc > 3 ? std::atoi(argv[3]) : 1000;
+    int depth = argc > 4 ? std::atoi(argv[4]) : 8;
+    
+    int epollFd = ::epoll_create1(0);
+    std::vector<Gate> gates(gateCount);
+    for (int g = 0; g < gateCount; g++) {
+        gates[g].fd = connectTo(endpoint);
+        if (gates[g].fd < 0) {
+            std::cout << "Cannot connect gate " << g << " to " << endpoint << std::endl;
+            return 1;
+        }
+        gates[g].sent = 0;
+        gates[g].inFlight = 0;
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = g;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, gates[g].fd, &ev);
+    }
+    
+    // Request ids are global so send times can live in one flat array
+    size_t total = static_cast<size_t>(gateCount) * perGate;
+    std::vector<Clock::time_point> sentAt(total);
+    std::vector<uint8_t> opcodeOf(total);
+    std::vector<double> latencies;
+    latencies.reserve(total);
+    uint32_t nextRequest = 0;
+    size_t completed = 0;
+    size_t errors = 0;
+    
+    auto topUp = [&](Gate& gate, int index) {
+        while (gate.inFlight < depth && gate.sent < perGate) {
+            uint32_t id = nextRequest++;
+            if (!gate.ticketsToReturn.empty()) {
+                GateProtocol::Writer(gate.output, id, GateProtocol::UNPARK).put<int32_t>(gate.ticketsToReturn.back());
+                gate.ticketsToReturn.pop_back();
+                opcodeOf[id] = GateProtocol::UNPARK;
+            } else if (gate.sent % 4 == 3) {
+                GateProtocol::Writer(gate.output, id, GateProtocol::OCCUPANCY);
+                opcodeOf[id] = GateProtocol::OCCUPANCY;
+            } else {
+                std::string plate = "G" + std::to_string(index) + "-" + std::to_string(gate.sent);
+                GateProtocol::Writer(gate.output, id, GateProtocol::PARK)
+                    .put<uint8_t>(static_cast<uint8_t>(gate.sent % 3)).put<uint8_t>(0).put<uint8_t>(0)
+                    .putString(plate).putString("load");
+                opcodeOf[id] = GateProtocol::PARK;
+            }
+            sentAt[id] = Clock::now();
+            gate.sent++;
+            gate.inFlight++;
+        }
+        if (!gate.output.empty()) {
+            ssize_t n = ::write(gate.fd, gate.output.data(), gate.output.size());
+            if (n > 0) gate.output.erase(gate.output.begin(), gate.output.begin() + n);
+        }
+    };
+    
+    Clock::time_point start = Clock::now();
+    for (int g = 0; g < gateCount; g++) {
+        topUp(gates[g], g);
+    }
+    
+    std::vector<epoll_event> events(1024);
+    uint8_t buffer[64 * 1024];
+    while (completed < total) {
+        int n = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 1000);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            std::cout << "Timed out waiting for responses" << std::endl;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            int index = static_cast<int>(events[i].data.u32);
+            Gate& gate = gates[index];
+            ssize_t got = ::read(gate.fd, buffer, sizeof(buffer));
+            if (got <= 0) continue;
+            gate.input.insert(gate.input.end(), buffer, buffer + got);
+            
+            size_t offset = 0;
+            GateProtocol::Frame frame;
+            long used;
+            while ((used = GateProtocol::parseFrame(gate.input.data() + offset, gate.input.size() - offset, frame)) > 0) {
+                Clock::time_point now = Clock::now();
+                if (frame.requestId < total) {
+                    latencies.push_back(std::chrono::duration<double, std::micro>(now - sentAt[frame.requestId]).count());
+                }
+                if (frame.code == GateProtocol::OK) {
+                    if (frame.requestId < total && opcodeOf[frame.requestId] == GateProtocol::PARK) {
+                        GateProtocol::Reader in(frame.payload, frame.length);
+                        gate.ticketsToReturn.push_back(in.get<int32_t>());
+                    }
+                } else if (frame.code != GateProtocol::OK && frame.code != GateProtocol::NO_SLOT) {
+                    errors++;
+                }
+                gate.inFlight--;
+                completed++;
+                offset += used;
+            }
+            gate.input.erase(gate.input.begin(), gate.input.begin() + offset);
+            topUp(gate, index);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        if (latencies.empty()) return 0.0;
+        size_t at = static_cast<size_t>(p * (latencies.size() - 1));
+        return latencies[at];
+    };
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Gates: " << gateCount << ", pipeline depth: " << depth << std::endl;
+    std::cout << "Requests: " << completed << " in " << seconds << " s ("
+              << completed / seconds << " req/s), errors: " << errors << std::endl;
+    std::cout << "Latency us: p50 " << percentile(0.50) << ", p99 " << percentile(0.99)
+              << ", p99.9 " << percentile(0.999) << ", max " << percentile(1.0) << std::endl;
+    
+    for (auto& gate : gates) {
+        ::close(gate.fd);
+    }
+    ::close(epollFd);
+    return 0;
+}
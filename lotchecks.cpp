@@ -0,0 +1,138 @@
+// Regression checks for the modular lot.
+// Usage: lotchecks [operations] [seed]
+// Each check drives a default lot or its tickets on a virtual clock and
+// asserts one property; failures are printed. Exit code 1 if any check fails.
+// Build: g++ -std=c++20 -O2 lotchecks.cpp <modular sources except main.cpp,
+//        soalno3UAP.cpp, loadtestclient.cpp, diffharness.cpp and
+//        staydriver.cpp> -o lotchecks
+#include "ParkingLot.h"
+#include "AllocationPolicy.h"
+#include "ParkingClock.h"
+#include "Settlement.h"
+#include "Ticket.h"
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The lot reports to std::cout, which is redirected while checks run
+static std::vector<std::string> failures;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok) failures.push_back(what);
+}
+
+static const SlotView* findSlot(const OccupancySnapshot& snapshot, const std::string& id) {
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        if (snapshot.slot(i).id == id) return &snapshot.slot(i);
+    }
+    return nullptr;
+}
+
+static bool regularFree(const OccupancySnapshot& snapshot) {
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        const SlotView& slot = snapshot.slot(i);
+        if (slot.kind == SlotKind::REGULAR && !slot.occupied) return true;
+    }
+    return false;
+}
+
+// A vehicle without special needs never takes a VIP bay while a regular bay
+// is free, under every allocation policy
+template <typename Policy>
+static void checkVipLast(const char* name, size_t operations, unsigned seed) {
+    VirtualClock clock(1700000000);
+    Policy policy;
+    ParkingLot lot;
+    lot.setEnforceOperatingHours(false);
+    lot.setAllocationPolicy(&policy);
+    std::mt19937 rng(seed);
+    std::vector<int> live;
+    for (size_t i = 0; i < operations; i++) {
+        clock.set(clock.now() + rng() % 900);
+        if (rng() % 100 < 60 || live.empty()) {
+            std::string plate = "B " + std::to_string(i) + " CK";
+            std::shared_ptr<Vehicle> v;
+            switch (rng() % 3) {
+                case 0: v = std::make_shared<Motorcycle>(plate, "owner"); break;
+                case 1: v = std::make_shared<Car>(plate, "owner"); break;
+                default: v = std::make_shared<EV>(plate, "owner", false); break;
+            }
+            bool hadRegular = regularFree(*lot.snapshot());
+            try {
+                auto ticket = lot.parkVehicle(v);
+                live.push_back(ticket->getId());
+                const SlotView* slot = findSlot(*lot.snapshot(), ticket->getSlotId());
+                expect(slot && !(hadRegular && slot->kind == SlotKind::VIP),
+                       std::string(name) + ": " + v->getTypeName() + " " + plate + " took VIP slot "
+                       + ticket->getSlotId() + " while a regular slot was free");
+            } catch (const NoAvailableSlotException&) {
+                expect(!hadRegular, std::string(name) + ": no slot for " + plate + " while a regular slot was free");
+            }
+        } else {
+            size_t pick = rng() % live.size();
+            lot.unparkVehicle(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+}
+
+// A charging EV pays no charging fee in a VIP slot, with or without a rate
+// fixed at entry, and the exit fee equals what settlement accrues for it
+static void checkChargingFeeInVip() {
+    const time_t entry = 1700000000;
+    const char* slots[] = { "V1", "R1", "E1" };
+    const double rates[] = { 0, 6000 }; // static tariff, dynamic rate
+    const int durations[] = { 1, 3, 30 };
+    for (const char* slotId : slots) {
+        for (double rate : rates) {
+            for (int hours : durations) {
+                VirtualClock clock(entry);
+                Ticket charging(slotId, std::make_shared<EV>("EV CHG", "owner", true));
+                Ticket plain(slotId, std::make_shared<EV>("EV PLN", "owner", false));
+                charging.setHourlyRate(rate);
+                plain.setHourlyRate(rate);
+                time_t exitTime = entry + hours * 3600;
+                double fee = charging.calculateFee(exitTime);
+                std::string label = std::string(slotId) + " at " + (rate > 0 ? "dynamic" : "static") + " rate, "
+                                  + std::to_string(hours) + " h: ";
+                
+                double hourly, flat, accrued;
+                charging.getTariff(hourly, flat);
+                int64_t entered = entry;
+                double energy = 0;
+                SettlementJob::priceRange(&entered, &hourly, &flat, &energy, &accrued, 1, exitTime);
+                expect(fee == accrued, label + "exit fee " + std::to_string(fee) + ", settlement accrues "
+                       + std::to_string(accrued));
+                if (slotId[0] == 'V') {
+                    expect(fee == plain.calculateFee(exitTime), label + "charging fee charged in a VIP slot");
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    unsigned seed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    
+    std::ostringstream sink;
+    std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+    checkVipLast<NearestEntrancePolicy>("NearestEntrance", operations, seed);
+    checkVipLast<FloorByFloorPolicy>("FloorByFloor", operations, seed);
+    checkVipLast<SpreadFloorsPolicy>("SpreadFloors", operations, seed);
+    checkChargingFeeInVip();
+    std::cout.rdbuf(saved);
+    
+    for (size_t i = 0; i < failures.size() && i < 20; i++) {
+        std::cout << "FAIL: " << failures[i] << std::endl;
+    }
+    std::cout << "Checks: " << operations << " operations per policy, seed " << seed << ", "
+              << failures.size() << " failures" << std::endl;
+    return failures.empty() ? 0 : 1;
+}
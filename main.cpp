@@ -1,6 +1,199 @@
 #include "ParkingSystemUI.h"
+#include "GateServer.h"
+#include "PlateIngest.h"
+#include "SlotMixOptimizer.h"
+#include "OccupancyRenderer.h"
+#include "OccupancyFeed.h"
+#include "FacilityRouter.h"
+#include "GateSession.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    // Server mode: parking_system --server <socket path | tcp port> [--display] [--signs]
+    //                                             [--facilities name,name,...]
+    // --display prints changed slots and floor totals to stdout every refresh;
+    // --signs prints "FREE: n" per floor whenever availability changes;
+    // --facilities serves several facilities, one shard thread each, with
+    // gates choosing theirs through the FACILITY request
+    if (argc >= 4 && std::string(argv[1]) == "--server" && std::string(argv[3]) == "--facilities") {
+        try {
+            FacilityRouter router;
+            std::string names = argc >= 5 ? argv[4] : "";
+            for (size_t begin = 0; begin <= names.size(); ) {
+                size_t end = std::min(names.find(',', begin), names.size());
+                if (end > begin) router.addFacility(names.substr(begin, end - begin), 0, 0);
+                begin = end + 1;
+            }
+            GateServer server(router, argv[2]);
+            server.listen();
+            std::cout << "Gate server for " << router.facilityCount() << " facilities listening on "
+                      << argv[2] << std::endl;
+            server.run();
+        } catch (const ParkingException& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 3 && std::string(argv[1]) == "--server") {
+        try {
+            ParkingLot lot;
+            OccupancyFeed feed(SystemConfig::OCCUPANCY_FEED_CAPACITY);
+            lot.setOccupancyFeed(&feed);
+            GateServer server(lot, argv[2]);
+            server.listen();
+            std::cout << "Gate server listening on " << argv[2] << std::endl;
+            
+            // Stops and joins the display threads however the server loop ends
+            struct DisplayThreads {
+                std::atomic<bool> running;
+                std::vector<std::thread> threads;
+                DisplayThreads() : running(true) {}
+                ~DisplayThreads() {
+                    running = false;
+                    for (auto& thread : threads) thread.join();
+                }
+            } displays;
+            std::atomic<bool>& running = displays.running;
+            for (int i = 3; i < argc; i++) {
+                if (std::string(argv[i]) == "--display") {
+                    displays.threads.emplace_back([&lot, &running]() {
+                        OccupancyRenderer renderer;
+                        while (running.load()) {
+                            renderer.writeFrame(1, lot.snapshot());
+                            std::this_thread::sleep_for(std::chrono::milliseconds(SystemConfig::DISPLAY_REFRESH_MS));
+                        }
+                    });
+                } else if (std::string(argv[i]) == "--signs") {
+                    displays.threads.emplace_back([&lot, &running]() {
+                        FloorSigns signs(lot.subscribeOccupancy());
+                        signs.print(std::cout);
+                        while (running.load()) {
+                            if (signs.update()) {
+                                signs.print(std::cout);
+                            } else {
+                                std::this_thread::sleep_for(std::chrono::milliseconds(SystemConfig::SIGN_POLL_MS));
+                            }
+                        }
+                    });
+                }
+            }
+            server.run();
+        } catch (const ParkingException& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    // Terminal mode: parking_system --terminals <socket path | tcp port> [worker threads]
+    // Line-based operator terminals (e.g. `nc -U path`), each running the
+    // gate dialogs as a coroutine session on a few worker threads
+    if (argc >= 3 && std::string(argv[1]) == "--terminals") {
+        try {
+            ParkingLot lot;
+            MemberRegistry members;
+            Waitlist waitlist;
+            if (SystemConfig::ENABLE_MEMBER_DISCOUNT) {
+                try {
+                    members.reload(SystemConfig::MEMBER_REGISTRY_FILE);
+                } catch (const ParkingException&) {
+                    // No member file yet: everyone pays the regular tariff
+                }
+                lot.setMemberRegistry(&members);
+            }
+            if (SystemConfig::ENABLE_WAITLIST) {
+                lot.setWaitlist(&waitlist);
+            }
+            int threads = argc >= 4 ? std::atoi(argv[3]) : SystemConfig::TERMINAL_WORKER_THREADS;
+            TerminalServer server(lot, &members, argv[2], threads > 0 ? threads : 1);
+            server.listen();
+            std::cout << "Terminal server listening on " << argv[2] << std::endl;
+            server.run();
+        } catch (const ParkingException& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    // Ingest mode: parking_system --ingest <plate event file | ->
+    if (argc >= 3 && std::string(argv[1]) == "--ingest") {
+        try {
+            ParkingLot lot;
+            PlateIngestPipeline pipeline(lot, SystemConfig::PLATE_DEDUP_WINDOW_SECONDS,
+                                         SystemConfig::PLATE_INGEST_BATCH_SIZE);
+            PlateIngestPipeline::Stats stats = pipeline.runFile(argv[2]);
+            std::cout << "Lines: " << stats.lines
+                      << ", malformed: " << stats.malformed
+                      << ", duplicates: " << stats.duplicates
+                      << ", parked: " << stats.parked
+                      << ", unparked: " << stats.unparked
+                      << ", rejected: " << stats.rejected << std::endl;
+        } catch (const ParkingException& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+#ifndef PARKING_STATIC_LAYOUT
+    // Layout optimizer: parking_system --optimize-slots [days of history]
+    if (argc >= 2 && std::string(argv[1]) == "--optimize-slots") {
+        int days = argc >= 3 ? std::atoi(argv[2]) : OptimizerConfig::DEFAULT_HISTORY_DAYS;
+        time_t to = time(0);
+        time_t from = to - static_cast<time_t>(days) * 24 * 3600;
+        
+        PaymentHistory history(SystemConfig::PAYMENT_HISTORY_DIR);
+        ThreadPool pool;
+        SlotMixOptimizer optimizer(pool);
+        optimizer.setDemand(SlotMixOptimizer::loadDemand(history, from, to));
+        if (optimizer.demandSize() == 0) {
+            std::cout << "No recorded stays in the last " << days << " days" << std::endl;
+            return 1;
+        }
+        
+        auto started = std::chrono::steady_clock::now();
+        SlotMix current = { ParkingLayout::REGULAR_SLOT_COUNT, ParkingLayout::EV_SLOT_COUNT,
+                            ParkingLayout::VIP_SLOT_COUNT };
+        LayoutScore baseline;
+        try {
+            baseline = optimizer.evaluate({ current }).front();
+            optimizer.anneal(current);
+        } catch (const ParkingException& e) {
+            // Rethrown from the replay workers
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::vector<LayoutScore> ranking = optimizer.ranking();
+        
+        std::cout << "Replayed " << optimizer.demandSize() << " stays against " << ranking.size()
+                  << " layouts in " << std::fixed << std::setprecision(1) << seconds << " s ("
+                  << pool.size() << " threads)" << std::endl;
+        std::cout << "Regular/EV/VIP   Revenue (Rp)   Rejected   Score" << std::endl;
+        auto print = [](const char* label, const LayoutScore& score) {
+            std::cout << label << score.mix.regular << "/" << score.mix.ev << "/" << score.mix.vip
+                      << "   " << std::setprecision(0) << score.revenue
+                      << "   " << std::setprecision(1) << score.rejectionRate() * 100 << "%"
+                      << "   " << std::setprecision(0) << score.score << std::endl;
+        };
+        print("current  ", baseline);
+        for (size_t i = 0; i < ranking.size() && i < 5; i++) {
+            print("candidate ", ranking[i]);
+        }
+        return 0;
+    }
+#endif
 
-int main() {
     ParkingSystemUI system;
     system.run();
     return 0;
@@ -0,0 +1,237 @@
+#include "MemberRegistry.h"
+#include "Exceptions.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// MemberTable implementation
+MemberTable::MemberTable(size_t expectedMembers) : memberCount(0) {
+    // Keep the Robin Hood table at most ~80% full
+    size_t capacity = 16;
+    while (capacity * 4 < expectedMembers * 5) capacity <<= 1;
+    entries.assign(capacity, Entry());
+    mask = capacity - 1;
+    
+    // ~10 bits per member
+    bloomBlocks = expectedMembers / 51 + 1;
+    bloom.assign(bloomBlocks * 8, 0);
+}
+
+size_t MemberTable::normalize(const std::string& plate, char (&out)[MAX_PLATE]) {
+    return normalize(plate.data(), plate.data() + plate.size(), out);
+}
+
+size_t MemberTable::normalize(const char* begin, const char* end, char (&out)[MAX_PLATE]) {
+    // Plain ASCII tests: the locale-aware <cctype> calls cost more than the lookup
+    size_t length = 0;
+    for (const char* p = begin; p < end; p++) {
+        char c = *p;
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        else if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) continue;
+        if (length == MAX_PLATE) return 0;
+        out[length++] = c;
+    }
+    return length;
+}
+
+uint64_t MemberTable::mixPlate(const char* plate, size_t length) {
+    // FNV-1a followed by a 64-bit finalizer so the low bits mix well
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ static_cast<unsigned char>(plate[i])) * 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t MemberTable::hashPlate(const char* plate, size_t length) {
+    // 0 marks an empty entry. Set the top bit, not the low one: the low
+    // bits pick the home slot and the Bloom bits.
+    return mixPlate(plate, length) | (1ULL << 63);
+}
+
+void MemberTable::bloomAdd(uint64_t hash) {
+    uint64_t* block = &bloom[((hash >> 32) % bloomBlocks) * 8];
+    for (int i = 0; i < 4; i++) {
+        unsigned bit = (hash >> (i * 9)) & 511;
+        block[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool MemberTable::bloomMayContain(uint64_t hash) const {
+    const uint64_t* block = &bloom[((hash >> 32) % bloomBlocks) * 8];
+    for (int i = 0; i < 4; i++) {
+        unsigned bit = (hash >> (i * 9)) & 511;
+        if (!(block[bit >> 6] & (1ULL << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+void MemberTable::insert(const char* plate, size_t plateLength, uint64_t hash,
+                         const char* name, size_t nameLength) {
+    if (memberCount + 1 > (mask + 1) * 4 / 5) {
+        // Grow past the planned size: reinsert everything into a table twice as large
+        std::vector<Entry> old;
+        old.swap(entries);
+        entries.assign(old.size() * 2, Entry());
+        mask = entries.size() - 1;
+        memberCount = 0;
+        for (const Entry& e : old) {
+            if (e.hash) place(e);
+        }
+    }
+    
+    Entry* existing = const_cast<Entry*>(find(plate, plateLength, hash));
+    uint32_t nameOffset = static_cast<uint32_t>(names.size());
+    if (nameLength > 0xffff) nameLength = 0xffff;
+    names.insert(names.end(), name, name + nameLength);
+    if (existing) {
+        // Later lines win
+        existing->nameOffset = nameOffset;
+        existing->nameLength = static_cast<uint16_t>(nameLength);
+        return;
+    }
+    
+    Entry moving = Entry();
+    moving.hash = hash;
+    moving.nameOffset = nameOffset;
+    moving.nameLength = static_cast<uint16_t>(nameLength);
+    moving.plateLength = static_cast<uint8_t>(plateLength);
+    std::memcpy(moving.plate, plate, plateLength);
+    
+    place(moving);
+    bloomAdd(hash);
+}
+
+void MemberTable::place(Entry moving) {
+    // Robin Hood: an entry further from its home slot takes the place of a
+    // closer one, which keeps probe lengths short and lets lookups stop early
+    size_t index = moving.hash & mask;
+    size_t distance = 0;
+    while (entries[index].hash) {
+        size_t residentDistance = (index - (entries[index].hash & mask)) & mask;
+        if (residentDistance < distance) {
+            std::swap(moving, entries[index]);
+            distance = residentDistance;
+        }
+        index = (index + 1) & mask;
+        distance++;
+    }
+    entries[index] = moving;
+    memberCount++;
+}
+
+const MemberTable::Entry* MemberTable::find(const char* plate, size_t plateLength, uint64_t hash) const {
+    size_t index = hash & mask;
+    for (size_t distance = 0; ; distance++) {
+        const Entry& e = entries[index];
+        if (!e.hash) return nullptr;
+        if (((index - (e.hash & mask)) & mask) < distance) return nullptr;
+        if (e.hash == hash && e.plateLength == plateLength &&
+            std::memcmp(e.plate, plate, plateLength) == 0) {
+            return &e;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+std::shared_ptr<const MemberTable> MemberTable::load(const std::string& path) {
+    std::FILE* input = std::fopen(path.c_str(), "rb");
+    if (!input) {
+        throw ParkingException("Cannot open member file: " + path);
+    }
+    std::vector<char> data;
+    char chunk[1 << 16];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        data.insert(data.end(), chunk, chunk + got);
+    }
+    std::fclose(input);
+    
+    size_t lines = 1;
+    for (char c : data) lines += (c == '\n');
+    auto table = std::make_shared<MemberTable>(lines);
+    
+    const char* p = data.data();
+    const char* end = p + data.size();
+    while (p < end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', lineEnd - p));
+        if (comma && comma > p) {
+            const char* nameEnd = lineEnd;
+            if (nameEnd > comma && nameEnd[-1] == '\r') nameEnd--;
+            char plate[MAX_PLATE];
+            size_t plateLength = normalize(p, comma, plate);
+            if (plateLength > 0) {
+                table->insert(plate, plateLength, hashPlate(plate, plateLength), comma + 1, nameEnd - comma - 1);
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return table;
+}
+
+void MemberTable::add(const std::string& plate, const std::string& name) {
+    char key[MAX_PLATE];
+    size_t length = normalize(plate, key);
+    if (length == 0) return;
+    insert(key, length, hashPlate(key, length), name.data(), name.size());
+}
+
+bool MemberTable::contains(const std::string& plate) const {
+    char key[MAX_PLATE];
+    size_t length = normalize(plate, key);
+    if (length == 0) return false;
+    uint64_t hash = hashPlate(key, length);
+    return bloomMayContain(hash) && find(key, length, hash) != nullptr;
+}
+
+std::string MemberTable::memberName(const std::string& plate) const {
+    char key[MAX_PLATE];
+    size_t length = normalize(plate, key);
+    if (length == 0) return "";
+    uint64_t hash = hashPlate(key, length);
+    if (!bloomMayContain(hash)) return "";
+    const Entry* e = find(key, length, hash);
+    return e ? std::string(names.data() + e->nameOffset, e->nameLength) : "";
+}
+
+size_t MemberTable::size() const { return memberCount; }
+
+// MemberRegistry implementation
+MemberRegistry::MemberRegistry() : current(std::make_shared<MemberTable>(0)) {}
+
+bool MemberRegistry::isMember(const std::string& plate) const {
+    return std::atomic_load(&current)->contains(plate);
+}
+
+std::string MemberRegistry::memberName(const std::string& plate) const {
+    return std::atomic_load(&current)->memberName(plate);
+}
+
+size_t MemberRegistry::size() const {
+    return std::atomic_load(&current)->size();
+}
+
+void MemberRegistry::replace(std::shared_ptr<const MemberTable> table) {
+    std::shared_ptr<const MemberTable> old = std::atomic_exchange(&current, table);
+    // Lookups hold the old table only for one probe. Wait them out so the
+    // (possibly huge) old table is freed here and never on a gate thread.
+    while (old.use_count() > 1) {
+        std::this_thread::yield();
+    }
+}
+
+size_t MemberRegistry::reload(const std::string& path) {
+    std::shared_ptr<const MemberTable> table = MemberTable::load(path);
+    replace(table);
+    return table->size();
+}
+
+std::future<size_t> MemberRegistry::reloadAsync(const std::string& path) {
+    return std::async(std::launch::async, [this, path] { return reload(path); });
+}
@@ -0,0 +1,87 @@
+#ifndef MEMBERREGISTRY_H
+#define MEMBERREGISTRY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Immutable member set built from a "plate,name" file. Lookups go through a
+// blocked Bloom filter first (one cache line per plate), so the common
+// non-member case costs a single memory access; hits are confirmed in a
+// Robin Hood hash table whose 32-byte entries hold the normalized plate
+// inline.
+class MemberTable {
+public:
+    static const size_t MAX_PLATE = 16;
+
+private:
+    struct Entry {
+        uint64_t hash;       // 0 = empty
+        uint32_t nameOffset; // into names
+        uint16_t nameLength;
+        uint8_t plateLength;
+        uint8_t reserved;
+        char plate[MAX_PLATE];
+    };
+    
+    std::vector<Entry> entries;     // power-of-two size
+    uint64_t mask;
+    std::vector<uint64_t> bloom;    // 512-bit blocks, 8 words each
+    uint64_t bloomBlocks;
+    std::vector<char> names;
+    size_t memberCount;
+    
+    void bloomAdd(uint64_t hash);
+    bool bloomMayContain(uint64_t hash) const;
+    void place(Entry moving);
+    void insert(const char* plate, size_t plateLength, uint64_t hash, const char* name, size_t nameLength);
+    const Entry* find(const char* plate, size_t plateLength, uint64_t hash) const;
+
+public:
+    explicit MemberTable(size_t expectedMembers);
+    
+    // Uppercase letters and digits only, so "b 1234 xy" matches "B1234XY".
+    // Returns 0 if the plate is empty or longer than MAX_PLATE.
+    static size_t normalize(const std::string& plate, char (&out)[MAX_PLATE]);
+    static size_t normalize(const char* begin, const char* end, char (&out)[MAX_PLATE]);
+    // Well-mixed 64-bit hash of a normalized plate
+    static uint64_t mixPlate(const char* plate, size_t length);
+    // mixPlate, never 0; what the table and its Bloom filter use
+    static uint64_t hashPlate(const char* plate, size_t length);
+    
+    // Throws ParkingException if the file cannot be read
+    static std::shared_ptr<const MemberTable> load(const std::string& path);
+    
+    void add(const std::string& plate, const std::string& name);
+    bool contains(const std::string& plate) const;
+    // Empty when the plate is not a member
+    std::string memberName(const std::string& plate) const;
+    size_t size() const;
+};
+
+// The registry gates consult at entry and exit. Reads take the current
+// table with one atomic pointer load; reload() builds the replacement off to
+// the side and swaps it in, so gates never wait for a reload and a lookup
+// always sees one complete table.
+class MemberRegistry {
+private:
+    std::shared_ptr<const MemberTable> current; // only touched via std::atomic_load/store
+
+public:
+    MemberRegistry();
+    
+    bool isMember(const std::string& plate) const;
+    std::string memberName(const std::string& plate) const;
+    size_t size() const;
+    
+    void replace(std::shared_ptr<const MemberTable> table);
+    // Loads on the calling thread, then swaps; returns the new member count
+    size_t reload(const std::string& path);
+    // Same on a background thread
+    std::future<size_t> reloadAsync(const std::string& path);
+};
+
+#endif
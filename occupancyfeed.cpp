@@ -0,0 +1,102 @@
+#include "OccupancyFeed.h"
+#include "ConfigParking.h"
+
+// OccupancyFeed implementation
+OccupancyFeed::OccupancyFeed(size_t capacity) : ring(capacity) {}
+
+SlotState OccupancyFeed::stateOf(const SlotView& view) {
+    if (view.occupied) return SlotState::OCCUPIED;
+    return view.reserved ? SlotState::RESERVED : SlotState::FREE;
+}
+
+void OccupancyFeed::publish(const OccupancyDelta& delta) {
+    ring.publish(delta);
+}
+
+// FeedCursor implementation
+FeedCursor::FeedCursor(const OccupancyFeed& occupancyFeed, const SnapshotPublisher& publisher)
+    : feed(&occupancyFeed), snapshots(&publisher), position(0) {
+    resync();
+}
+
+const OccupancySnapshot& FeedCursor::baseline() const { return *base; }
+
+void FeedCursor::resync() {
+    // Position before snapshot: the publisher stores a version before it
+    // appends its delta, so every delta older than `position` is already in
+    // the snapshot; newer ones it contains are skipped by version in poll()
+    position = feed->ring.position();
+    base = snapshots->read();
+}
+
+bool FeedCursor::poll(std::vector<OccupancyDelta>& out, size_t max) {
+    OccupancyDelta delta;
+    for (size_t taken = 0; taken < max; position++) {
+        switch (feed->ring.read(position, delta)) {
+            case BroadcastRing<OccupancyDelta>::EMPTY:
+                return true;
+            case BroadcastRing<OccupancyDelta>::OVERRUN:
+                return false;
+            default:
+                if (delta.version > base->getVersion()) {
+                    out.push_back(delta);
+                    taken++;
+                }
+        }
+    }
+    return true;
+}
+
+uint64_t FeedCursor::lag() const {
+    return feed->ring.position() - position;
+}
+
+// FloorSigns implementation
+FloorSigns::FloorSigns(FeedCursor feedCursor) : cursor(feedCursor) {
+    rebuild();
+}
+
+void FloorSigns::rebuild() {
+    const OccupancySnapshot& base = cursor.baseline();
+    states.assign(base.size(), SlotState::FREE);
+    freeSlots.clear();
+    for (size_t i = 0; i < base.size(); i++) {
+        const SlotView& view = base.slot(i);
+        states[i] = OccupancyFeed::stateOf(view);
+        if (static_cast<size_t>(view.level) >= freeSlots.size()) {
+            freeSlots.resize(view.level + 1, 0);
+        }
+        if (states[i] == SlotState::FREE) freeSlots[view.level]++;
+    }
+}
+
+bool FloorSigns::update() {
+    batch.clear();
+    if (!cursor.poll(batch, SystemConfig::OCCUPANCY_FEED_CAPACITY)) {
+        cursor.resync();
+        rebuild();
+        return true;
+    }
+    bool changed = false;
+    for (const OccupancyDelta& delta : batch) {
+        if (delta.slotIndex >= states.size() || delta.level >= freeSlots.size()) continue;
+        SlotState& state = states[delta.slotIndex];
+        if (state == delta.state) continue;
+        if (state == SlotState::FREE) freeSlots[delta.level]--;
+        if (delta.state == SlotState::FREE) freeSlots[delta.level]++;
+        state = delta.state;
+        changed = true;
+    }
+    return changed;
+}
+
+int FloorSigns::freeOn(int level) const {
+    return level >= 0 && static_cast<size_t>(level) < freeSlots.size() ? freeSlots[level] : 0;
+}
+
+void FloorSigns::print(std::ostream& os) const {
+    for (size_t level = 1; level < freeSlots.size(); level++) {
+        os << "Floor " << level << " FREE: " << freeSlots[level] << '\n';
+    }
+    os.flush();
+}
@@ -0,0 +1,86 @@
+#ifndef OCCUPANCYFEED_H
+#define OCCUPANCYFEED_H
+
+#include "BroadcastRing.h"
+#include "OccupancySnapshot.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+enum class SlotState : uint8_t { FREE, OCCUPIED, RESERVED };
+
+// One slot changing state. slotIndex addresses OccupancySnapshot::slot();
+// version is the snapshot version that contains the change.
+struct OccupancyDelta {
+    uint64_t version;
+    uint32_t slotIndex;
+    uint8_t level;
+    SlotKind kind;
+    SlotState state;
+    uint8_t unused;
+};
+
+// Change feed for availability signs and the mobile app. The lot's snapshot
+// publisher appends a delta after each new snapshot version; any number of
+// FeedCursors follow it without locks and without slowing the lot down.
+class OccupancyFeed {
+private:
+    BroadcastRing<OccupancyDelta> ring;
+    
+    friend class FeedCursor;
+    
+public:
+    explicit OccupancyFeed(size_t capacity);
+    
+    static SlotState stateOf(const SlotView& view);
+    
+    // Lot thread only
+    void publish(const OccupancyDelta& delta);
+};
+
+// A subscriber's position in the feed plus the snapshot it started from.
+// Apply deltas from poll() on top of baseline(); when poll() reports an
+// overrun the subscriber fell a whole ring behind, and resync() takes a
+// fresh baseline to rebuild from.
+class FeedCursor {
+private:
+    const OccupancyFeed* feed;
+    const SnapshotPublisher* snapshots;
+    uint64_t position;
+    std::shared_ptr<const OccupancySnapshot> base;
+    
+public:
+    FeedCursor(const OccupancyFeed& occupancyFeed, const SnapshotPublisher& publisher);
+    
+    const OccupancySnapshot& baseline() const;
+    
+    // Appends up to `max` new deltas to `out`; false after an overrun
+    bool poll(std::vector<OccupancyDelta>& out, size_t max);
+    void resync();
+    
+    // Deltas published but not yet polled
+    uint64_t lag() const;
+};
+
+// Per-floor free-slot counts for the "FREE: n" guidance signs, kept current
+// from a cursor. Resynchronises from a fresh snapshot after an overrun.
+class FloorSigns {
+private:
+    FeedCursor cursor;
+    std::vector<SlotState> states; // by slot index
+    std::vector<int> freeSlots;    // by level
+    std::vector<OccupancyDelta> batch;
+    
+    void rebuild();
+    
+public:
+    explicit FloorSigns(FeedCursor feedCursor);
+    
+    // Applies new deltas; true if any count changed
+    bool update();
+    int freeOn(int level) const;
+    void print(std::ostream& os) const;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "OccupancyForecast.h"
+#include "ConfigParking.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+    int64_t floorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+    
+    int64_t localUtcOffset() {
+        time_t now = time(0);
+        std::tm utc = *std::gmtime(&now);
+        utc.tm_isdst = -1;
+        return static_cast<int64_t>(now - std::mktime(&utc));
+    }
+    
+    size_t seasonIndex(int64_t step, size_t length) {
+        int64_t r = step % static_cast<int64_t>(length);
+        return static_cast<size_t>(r < 0 ? r + static_cast<int64_t>(length) : r);
+    }
+}
+
+OccupancyForecaster::OccupancyForecaster()
+    : stepSeconds(ForecastConfig::STEP_MINUTES * 60),
+      stepsPerDay(24 * 60 / ForecastConfig::STEP_MINUTES),
+      utcOffset(localUtcOffset()) {}
+
+OccupancyForecaster::Cell* OccupancyForecaster::cellFor(int floor, SlotKind kind) {
+    size_t index = static_cast<size_t>(floor) * KINDS + static_cast<int>(kind);
+    return index < cells.size() ? &cells[index] : nullptr;
+}
+
+const OccupancyForecaster::Cell* OccupancyForecaster::cellFor(int floor, SlotKind kind) const {
+    size_t index = static_cast<size_t>(floor) * KINDS + static_cast<int>(kind);
+    return index < cells.size() && cells[index].capacity > 0 ? &cells[index] : nullptr;
+}
+
+void OccupancyForecaster::registerSlot(const ParkingSlot& slot) {
+    size_t index = static_cast<size_t>(slot.getLevel()) * KINDS + static_cast<int>(slot.getKind());
+    if (index >= cells.size()) {
+        cells.resize(index + 1);
+    }
+    Cell& cell = cells[index];
+    if (cell.daily.empty()) {
+        cell.capacity = 0;
+        cell.occupied = 0;
+        cell.step = -1;
+        cell.lastEvent = 0;
+        cell.occupiedSeconds = 0;
+        cell.initialized = false;
+        cell.level = 0;
+        cell.trend = 0;
+        cell.daily.assign(stepsPerDay, 0.0);
+        cell.weekly.assign(stepsPerDay * 7, 0.0);
+    }
+    cell.capacity++;
+    if (slot.isOccupied()) cell.occupied++;
+}
+
+void OccupancyForecaster::learn(Cell& cell, int64_t step, double observed) {
+    if (!cell.initialized) {
+        cell.level = observed;
+        cell.trend = 0;
+        cell.initialized = true;
+        return;
+    }
+    double& daily = cell.daily[seasonIndex(step, cell.daily.size())];
+    double& weekly = cell.weekly[seasonIndex(step, cell.weekly.size())];
+    
+    double previousLevel = cell.level;
+    cell.level = ForecastConfig::LEVEL_SMOOTHING * (observed - daily - weekly)
+               + (1 - ForecastConfig::LEVEL_SMOOTHING) * (cell.level + cell.trend);
+    cell.trend = ForecastConfig::TREND_SMOOTHING * (cell.level - previousLevel)
+               + (1 - ForecastConfig::TREND_SMOOTHING) * cell.trend;
+    double newDaily = ForecastConfig::DAILY_SMOOTHING * (observed - cell.level - weekly)
+                    + (1 - ForecastConfig::DAILY_SMOOTHING) * daily;
+    weekly = ForecastConfig::WEEKLY_SMOOTHING * (observed - cell.level - daily)
+           + (1 - ForecastConfig::WEEKLY_SMOOTHING) * weekly;
+    daily = newDaily;
+}
+
+void OccupancyForecaster::advance(Cell& cell, time_t now) {
+    int64_t step = floorDiv(static_cast<int64_t>(now) + utcOffset, stepSeconds);
+    if (cell.step < 0) {
+        cell.step = step;
+        cell.lastEvent = now;
+        cell.occupiedSeconds = 0;
+        return;
+    }
+    if (now < cell.lastEvent) now = cell.lastEvent; // out-of-order event: count it as simultaneous
+    
+    // Close every step boundary crossed since the last event. Each closed
+    // step is one O(1) update; the count depends on elapsed time, not on
+    // how many events there were.
+    while (cell.step < step) {
+        int64_t stepEnd = (cell.step + 1) * stepSeconds - utcOffset;
+        cell.occupiedSeconds += cell.occupied * static_cast<double>(stepEnd - cell.lastEvent);
+        learn(cell, cell.step, cell.occupiedSeconds / stepSeconds / cell.capacity);
+        cell.step++;
+        cell.lastEvent = stepEnd;
+        cell.occupiedSeconds = 0;
+    }
+    cell.occupiedSeconds += cell.occupied * static_cast<double>(now - cell.lastEvent);
+    cell.lastEvent = now;
+}
+
+void OccupancyForecaster::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    Cell* cell = cellFor(slot.getLevel(), slot.getKind());
+    if (!cell || cell->capacity == 0) return;
+    advance(*cell, when);
+    cell->occupied++;
+}
+
+void OccupancyForecaster::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    Cell* cell = cellFor(slot.getLevel(), slot.getKind());
+    if (!cell || cell->capacity == 0) return;
+    advance(*cell, when);
+    if (cell->occupied > 0) cell->occupied--;
+}
+
+double OccupancyForecaster::predict(const Cell& cell, int64_t step) const {
+    // Models are fitted on the fraction of the cell that is occupied
+    int64_t ahead = step - cell.step;
+    double fraction = cell.level + ahead * cell.trend
+                    + cell.daily[seasonIndex(step, cell.daily.size())]
+                    + cell.weekly[seasonIndex(step, cell.weekly.size())];
+    return std::min(1.0, std::max(0.0, fraction)) * cell.capacity;
+}
+
+double OccupancyForecaster::expectedOccupancy(int floor, SlotKind kind, time_t at) const {
+    const Cell* cell = cellFor(floor, kind);
+    if (!cell) return 0;
+    if (!cell->initialized) return cell->occupied;
+    return predict(*cell, floorDiv(static_cast<int64_t>(at) + utcOffset, stepSeconds));
+}
+
+OccupancyForecaster::Forecast OccupancyForecaster::forecast(int floor, SlotKind kind, time_t now) const {
+    Forecast result = { 0, 0, 0.0, -1 };
+    const Cell* cell = cellFor(floor, kind);
+    if (!cell) return result;
+    
+    result.capacity = cell->capacity;
+    result.occupied = cell->occupied;
+    result.expectedIn1h = expectedOccupancy(floor, kind, now + 3600);
+    if (cell->occupied >= cell->capacity) {
+        result.minutesUntilFull = 0;
+        return result;
+    }
+    if (!cell->initialized) return result;
+    
+    // Scan ahead step by step (bounded by the horizon) for the first step
+    // expected to be full
+    int64_t nowStep = floorDiv(static_cast<int64_t>(now) + utcOffset, stepSeconds);
+    int64_t steps = ForecastConfig::HORIZON_MINUTES * 60 / stepSeconds;
+    for (int64_t h = 1; h <= steps; h++) {
+        if (predict(*cell, nowStep + h) >= cell->capacity - 0.5) {
+            int64_t stepStart = (nowStep + h) * stepSeconds - utcOffset;
+            result.minutesUntilFull = static_cast<int>(std::max<int64_t>(0, stepStart - now) / 60);
+            break;
+        }
+    }
+    return result;
+}
+
+void OccupancyForecaster::printForecast(std::ostream& os, time_t now) const {
+    const SlotKind kinds[] = { SlotKind::REGULAR, SlotKind::EV, SlotKind::VIP };
+    const char* kindNames[] = { "Regular", "EV", "VIP" };
+    
+    os << "\n=== Occupancy Forecast ===\n" << std::fixed << std::setprecision(1);
+    for (size_t index = 0; index < cells.size(); index++) {
+        if (cells[index].capacity == 0) continue;
+        int floor = static_cast<int>(index / KINDS);
+        int k = static_cast<int>(index % KINDS);
+        Forecast f = forecast(floor, kinds[k], now);
+        os << "Floor " << floor << " " << kindNames[k] << ": " << f.occupied << "/" << f.capacity
+           << " now, ~" << f.expectedIn1h << " in 1h";
+        if (f.minutesUntilFull == 0) {
+            os << ", full";
+        } else if (f.minutesUntilFull > 0) {
+            os << ", full in ~" << f.minutesUntilFull << " min";
+        }
+        os << std::endl;
+    }
+}
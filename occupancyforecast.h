@@ -0,0 +1,66 @@
+#ifndef OCCUPANCYFORECAST_H
+#define OCCUPANCYFORECAST_H
+
+#include "ParkingObserver.h"
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <vector>
+
+// Online occupancy forecast per floor and slot kind. Each cell runs a
+// double-seasonal Holt-Winters model (level, trend, time-of-day and
+// day-of-week terms) over the time-weighted average occupancy of fixed
+// steps. A park or unpark only advances the occupancy integral; a step
+// boundary costs one constant-size model update, so there is no retraining
+// pass and nothing on the gate path grows with history.
+class OccupancyForecaster : public ParkingObserver {
+public:
+    static const int KINDS = 3;
+    
+    struct Forecast {
+        int capacity;
+        int occupied;
+        double expectedIn1h;   // occupied slots expected one hour from now
+        int minutesUntilFull;  // -1 if not expected within the horizon
+    };
+    
+private:
+    struct Cell {
+        int capacity;
+        int occupied;
+        int64_t step;           // step index currently being integrated, -1 before the first event
+        int64_t lastEvent;      // time of the last integration point
+        double occupiedSeconds; // integral of occupancy over the current step
+        bool initialized;
+        double level;
+        double trend;
+        std::vector<double> daily;   // one term per step of the day
+        std::vector<double> weekly;  // one term per step of the week
+    };
+    
+    std::vector<Cell> cells; // indexed by floor * KINDS + kind
+    int64_t stepSeconds;
+    int64_t stepsPerDay;
+    int64_t utcOffset;
+    
+    Cell* cellFor(int floor, SlotKind kind);
+    const Cell* cellFor(int floor, SlotKind kind) const;
+    void advance(Cell& cell, time_t now);
+    void learn(Cell& cell, int64_t step, double observed);
+    double predict(const Cell& cell, int64_t step) const;
+    
+public:
+    OccupancyForecaster();
+    
+    void registerSlot(const ParkingSlot& slot);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    // Expected occupied slots at `at`, clamped to [0, capacity]
+    double expectedOccupancy(int floor, SlotKind kind, time_t at) const;
+    Forecast forecast(int floor, SlotKind kind, time_t now) const;
+    void printForecast(std::ostream& os, time_t now) const;
+};
+
+#endif
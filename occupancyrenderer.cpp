@@ -0,0 +1,148 @@
+#include "OccupancyRenderer.h"
+#include <cerrno>
+#include <charconv>
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+namespace {
+    const size_t ROW_BYTES_ESTIMATE = 64;
+    
+    void appendInt(std::string& out, long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+    
+    bool sameRow(const SlotView& a, const SlotView& b) {
+        return a.occupied == b.occupied && a.reserved == b.reserved && a.plate == b.plate
+            && a.vehicleTypeName == b.vehicleTypeName && a.reservedFor == b.reservedFor;
+    }
+}
+
+OccupancyRenderer::OccupancyRenderer() {}
+
+void OccupancyRenderer::appendRow(const SlotView& view) {
+    buffer += "Slot ";
+    buffer += view.id;
+    buffer += " (";
+    buffer += view.slotType;
+    buffer += ", Level ";
+    appendInt(buffer, view.level);
+    buffer += "): ";
+    if (view.occupied) {
+        buffer += "Occupied by ";
+        buffer += view.vehicleTypeName;
+        buffer += " (";
+        buffer += view.plate;
+        buffer += ")";
+    } else if (view.reserved) {
+        buffer += "Reserved for ";
+        buffer += view.reservedFor;
+    } else {
+        buffer += "Available";
+    }
+    buffer += '\n';
+}
+
+void OccupancyRenderer::count(const SlotView& view, int delta) {
+    if (view.level < 0) return;
+    if (static_cast<size_t>(view.level) >= floors.size()) {
+        floors.resize(view.level + 1, FloorCount{ 0, 0, 0 });
+    }
+    FloorCount& floor = floors[view.level];
+    floor.total += delta;
+    if (view.occupied) floor.occupied += delta;
+    if (view.reserved) floor.reserved += delta;
+}
+
+void OccupancyRenderer::appendSummary(uint64_t version) {
+    for (size_t level = 0; level < floors.size(); level++) {
+        const FloorCount& floor = floors[level];
+        if (floor.total == 0) continue;
+        buffer += "Floor ";
+        appendInt(buffer, static_cast<long long>(level));
+        buffer += ": ";
+        appendInt(buffer, floor.occupied);
+        buffer += '/';
+        appendInt(buffer, floor.total);
+        buffer += " occupied, ";
+        appendInt(buffer, floor.reserved);
+        buffer += " reserved\n";
+    }
+    buffer += "--- v";
+    appendInt(buffer, static_cast<long long>(version));
+    buffer += " ---\n";
+}
+
+const std::string& OccupancyRenderer::frame(std::shared_ptr<const OccupancySnapshot> snapshot) {
+    buffer.clear();
+    if (!snapshot || snapshot == previous) {
+        return buffer;
+    }
+    
+    bool full = !previous || previous->size() != snapshot->size()
+             || previous->chunkCount() != snapshot->chunkCount();
+    if (full) {
+        floors.clear();
+        size_t needed = (snapshot->size() + 8) * ROW_BYTES_ESTIMATE;
+        if (buffer.capacity() < needed) {
+            buffer.reserve(needed);
+        }
+        buffer += "\n=== Current Occupation ===\n";
+        for (size_t i = 0; i < snapshot->size(); i++) {
+            const SlotView& view = snapshot->slot(i);
+            count(view, 1);
+            appendRow(view);
+        }
+    } else {
+        bool changed = false;
+        for (size_t c = 0; c < snapshot->chunkCount(); c++) {
+            const OccupancySnapshot::Chunk* before = previous->chunk(c);
+            const OccupancySnapshot::Chunk* after = snapshot->chunk(c);
+            if (before == after) continue;
+            for (size_t j = 0; j < after->size(); j++) {
+                if (sameRow((*before)[j], (*after)[j])) continue;
+                count((*before)[j], -1);
+                count((*after)[j], 1);
+                appendRow((*after)[j]);
+                changed = true;
+            }
+        }
+        if (!changed) {
+            // Only the totals moved; nothing on the display changes
+            previous = snapshot;
+            return buffer;
+        }
+    }
+    
+    appendSummary(snapshot->getVersion());
+    previous = snapshot;
+    return buffer;
+}
+
+bool OccupancyRenderer::writeFrame(int fd, std::shared_ptr<const OccupancySnapshot> snapshot) {
+    const std::string& out = frame(snapshot);
+    size_t written = 0;
+    while (written < out.size()) {
+        // One call per frame unless the descriptor takes a short write
+#ifndef _WIN32
+        ssize_t n = ::write(fd, out.data() + written, out.size() - written);
+#else
+        int n = ::_write(fd, out.data() + written, static_cast<unsigned>(out.size() - written));
+#endif
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void OccupancyRenderer::reset() {
+    previous.reset();
+}
@@ -0,0 +1,44 @@
+#ifndef OCCUPANCYRENDERER_H
+#define OCCUPANCYRENDERER_H
+
+#include "OccupancySnapshot.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Incremental occupancy display for large lots. Each frame lists only the
+// slots whose row changed since the previous frame, followed by one summary
+// line per floor; the first frame lists every slot. Changed slots are found
+// by comparing chunk pointers with the previous snapshot, so an idle lot
+// costs O(chunks) per frame. Rows use the printOccupation format.
+class OccupancyRenderer {
+private:
+    struct FloorCount {
+        int total;
+        int occupied;
+        int reserved;
+    };
+    
+    std::shared_ptr<const OccupancySnapshot> previous; // keeps its chunks alive for the pointer compare
+    std::vector<FloorCount> floors;                    // indexed by level
+    std::string buffer;                                // reused; grows to the largest frame
+    
+    void appendRow(const SlotView& view);
+    void count(const SlotView& view, int delta);
+    void appendSummary(uint64_t version);
+    
+public:
+    OccupancyRenderer();
+    
+    // Builds the next frame into the internal buffer; empty if nothing
+    // changed since the previous frame
+    const std::string& frame(std::shared_ptr<const OccupancySnapshot> snapshot);
+    
+    // frame() plus a single write() of the whole frame to fd
+    bool writeFrame(int fd, std::shared_ptr<const OccupancySnapshot> snapshot);
+    
+    // Next frame lists every slot again
+    void reset();
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "OccupancyRollup.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    int64_t floorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+    
+    int64_t localUtcOffset() {
+        time_t now = time(0);
+        std::tm utc = *std::gmtime(&now);
+        utc.tm_isdst = -1;
+        return static_cast<int64_t>(now - std::mktime(&utc));
+    }
+}
+
+// RollupRing implementation
+RollupRing::RollupRing(size_t size, int64_t bucketWidth, int64_t utcOffset)
+    : buckets(size), width(bucketWidth), offset(utcOffset), headKey(0) {
+    for (auto& bucket : buckets) {
+        bucket.start = -1;
+    }
+}
+
+int64_t RollupRing::keyOf(int64_t t) const {
+    return floorDiv(t + offset, width);
+}
+
+int64_t RollupRing::getWidth() const { return width; }
+
+int64_t RollupRing::bucketStart(int64_t t) const {
+    return keyOf(t) * width - offset;
+}
+
+int64_t RollupRing::oldestStart() const {
+    return (headKey - static_cast<int64_t>(buckets.size()) + 1) * width - offset;
+}
+
+RollupBucket* RollupRing::touch(int64_t t, const int32_t* occupancy) {
+    int64_t key = keyOf(t);
+    int64_t size = static_cast<int64_t>(buckets.size());
+    if (key > headKey) {
+        // Open every bucket skipped since the last event, at most one lap
+        for (int64_t k = std::max(headKey + 1, key - size + 1); k <= key; k++) {
+            RollupBucket& bucket = buckets[k % size];
+            bucket.start = k * width - offset;
+            std::memcpy(bucket.peakOccupancy, occupancy, sizeof(bucket.peakOccupancy));
+            std::memset(bucket.arrivals, 0, sizeof(bucket.arrivals));
+            std::memset(bucket.exits, 0, sizeof(bucket.exits));
+            std::fill(bucket.revenue, bucket.revenue + RollupBucket::CELLS, 0.0);
+        }
+        headKey = key;
+    }
+    RollupBucket& bucket = buckets[((key % size) + size) % size];
+    return bucket.start == key * width - offset ? &bucket : nullptr;
+}
+
+const RollupBucket* RollupRing::find(int64_t t) const {
+    int64_t key = keyOf(t);
+    int64_t size = static_cast<int64_t>(buckets.size());
+    if (key > headKey || key <= headKey - size) return nullptr;
+    const RollupBucket& bucket = buckets[((key % size) + size) % size];
+    return bucket.start == key * width - offset ? &bucket : nullptr;
+}
+
+// OccupancyRollup implementation
+OccupancyRollup::OccupancyRollup()
+    : utcOffset(localUtcOffset()),
+      minutes(RollupConfig::MINUTE_BUCKETS, 60, utcOffset),
+      hours(RollupConfig::HOUR_BUCKETS, 3600, utcOffset),
+      days(RollupConfig::DAY_BUCKETS, 86400, utcOffset) {
+    std::memset(occupancy, 0, sizeof(occupancy));
+}
+
+void OccupancyRollup::record(const ParkingSlot& slot, time_t when, int delta, double fee) {
+    // Open new buckets with the occupancy from before this event
+    RollupBucket* touched[3] = {
+        minutes.touch(when, occupancy),
+        hours.touch(when, occupancy),
+        days.touch(when, occupancy)
+    };
+    
+    int floor = slot.getLevel();
+    int kind = static_cast<int>(slot.getKind());
+    int cells[4];
+    int cellCount = 0;
+    if (floor >= 1 && floor <= RollupConfig::MAX_FLOORS) {
+        cells[cellCount++] = RollupBucket::cell(floor, kind);
+        cells[cellCount++] = RollupBucket::cell(floor, RollupBucket::ALL_KINDS);
+    }
+    cells[cellCount++] = RollupBucket::cell(0, kind);
+    cells[cellCount++] = RollupBucket::cell(0, RollupBucket::ALL_KINDS);
+    
+    for (int i = 0; i < cellCount; i++) {
+        occupancy[cells[i]] += delta;
+    }
+    for (RollupBucket* bucket : touched) {
+        if (!bucket) continue;
+        for (int i = 0; i < cellCount; i++) {
+            int c = cells[i];
+            if (delta > 0) bucket->arrivals[c]++;
+            else if (delta < 0) bucket->exits[c]++;
+            bucket->revenue[c] += fee;
+            bucket->peakOccupancy[c] = std::max(bucket->peakOccupancy[c], occupancy[c]);
+        }
+    }
+}
+
+void OccupancyRollup::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    record(slot, when, +1, 0.0);
+}
+
+void OccupancyRollup::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    record(slot, when, -1, fee);
+}
+
+void OccupancyRollup::onChargeReversed(const Ticket& ticket, const ParkingSlot& slot, time_t when, double amount) {
+    record(slot, when, 0, -amount);
+}
+
+const RollupRing& OccupancyRollup::levelFor(time_t from) const {
+    if (from >= minutes.oldestStart()) return minutes;
+    if (from >= hours.oldestStart()) return hours;
+    return days;
+}
+
+int OccupancyRollup::currentOccupancy(int floor, int kind) const {
+    if (floor < 0 || floor > RollupConfig::MAX_FLOORS) return 0;
+    return occupancy[RollupBucket::cell(floor, kind < 0 ? RollupBucket::ALL_KINDS : kind)];
+}
+
+OccupancyRollup::Totals OccupancyRollup::query(time_t from, time_t to, int floor, int kind) const {
+    Totals totals = { 0, 0, 0, 0.0 };
+    if (floor < 0 || floor > RollupConfig::MAX_FLOORS || to <= from) return totals;
+    int c = RollupBucket::cell(floor, kind < 0 ? RollupBucket::ALL_KINDS : kind);
+    
+    const RollupRing& ring = levelFor(from);
+    for (int64_t t = ring.bucketStart(from); t < to; t += ring.getWidth()) {
+        const RollupBucket* bucket = ring.find(t);
+        if (!bucket) continue;
+        totals.peakOccupancy = std::max(totals.peakOccupancy, static_cast<int>(bucket->peakOccupancy[c]));
+        totals.arrivals += bucket->arrivals[c];
+        totals.exits += bucket->exits[c];
+        totals.revenue += bucket->revenue[c];
+    }
+    return totals;
+}
+
+int OccupancyRollup::peakInDailyWindow(int startHour, int endHour, int dayCount, time_t now,
+                                       int floor, int kind) const {
+    if (floor < 0 || floor > RollupConfig::MAX_FLOORS) return 0;
+    int c = RollupBucket::cell(floor, kind < 0 ? RollupBucket::ALL_KINDS : kind);
+    int peak = 0;
+    for (int d = 0; d < dayCount; d++) {
+        int64_t dayStart = days.bucketStart(now - static_cast<int64_t>(d) * 86400);
+        for (int hour = startHour; hour < endHour; hour++) {
+            const RollupBucket* bucket = hours.find(dayStart + hour * 3600);
+            if (bucket) {
+                peak = std::max(peak, static_cast<int>(bucket->peakOccupancy[c]));
+            }
+        }
+    }
+    return peak;
+}
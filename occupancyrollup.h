@@ -0,0 +1,89 @@
+#ifndef OCCUPANCYROLLUP_H
+#define OCCUPANCYROLLUP_H
+
+#include "ParkingObserver.h"
+#include "ConfigParking.h"
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Counters for one time bucket. Cells are indexed by [floor][kind] where
+// floor 0 is the whole lot and kind ALL_KINDS sums every SlotKind.
+struct RollupBucket {
+    static const int KINDS = 4;
+    static const int ALL_KINDS = 3;
+    static const int CELLS = (RollupConfig::MAX_FLOORS + 1) * KINDS;
+    
+    int64_t start;
+    int32_t peakOccupancy[CELLS];
+    int32_t arrivals[CELLS];
+    int32_t exits[CELLS];
+    double revenue[CELLS];
+    
+    static int cell(int floor, int kind) { return floor * KINDS + kind; }
+};
+
+// Fixed-size ring of buckets of one width (minute, hour or day).
+class RollupRing {
+private:
+    std::vector<RollupBucket> buckets;
+    int64_t width;
+    int64_t offset;      // shifts bucket boundaries to local midnight
+    int64_t headKey;
+    
+    int64_t keyOf(int64_t t) const;
+    
+public:
+    RollupRing(size_t size, int64_t bucketWidth, int64_t utcOffset);
+    
+    // Bucket containing t, opening (and carrying occupancy into) any buckets
+    // skipped since the last event. Null if t is older than the ring.
+    RollupBucket* touch(int64_t t, const int32_t* occupancy);
+    const RollupBucket* find(int64_t t) const;
+    
+    int64_t getWidth() const;
+    int64_t bucketStart(int64_t t) const;
+    int64_t oldestStart() const;
+};
+
+// Per-minute, per-hour and per-day occupancy/arrival/exit/revenue rollups
+// per floor and slot kind. Every park/unpark updates all three levels in
+// O(1); range queries read the finest level that still covers the range.
+class OccupancyRollup : public ParkingObserver {
+public:
+    struct Totals {
+        int peakOccupancy;
+        long long arrivals;
+        long long exits;
+        double revenue;
+    };
+    
+private:
+    int32_t occupancy[RollupBucket::CELLS];
+    int64_t utcOffset;
+    RollupRing minutes;
+    RollupRing hours;
+    RollupRing days;
+    
+    void record(const ParkingSlot& slot, time_t when, int delta, double fee);
+    const RollupRing& levelFor(time_t from) const;
+    
+public:
+    OccupancyRollup();
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    void onChargeReversed(const Ticket& ticket, const ParkingSlot& slot, time_t when, double amount) override;
+    
+    // floor 0 = whole lot, kind -1 = all slot kinds. Ranges are [from, to)
+    // rounded outward to the bucket width used.
+    int currentOccupancy(int floor, int kind = -1) const;
+    Totals query(time_t from, time_t to, int floor = 0, int kind = -1) const;
+    
+    // Peak occupancy inside the daily window [startHour, endHour) over the
+    // last `days` days, e.g. the 07:00-09:00 peak-hour tariff window.
+    int peakInDailyWindow(int startHour, int endHour, int days, time_t now,
+                          int floor = 0, int kind = -1) const;
+};
+
+#endif
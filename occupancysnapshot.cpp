@@ -0,0 +1,167 @@
+#include "OccupancySnapshot.h"
+#include "OccupancyFeed.h"
+#include <atomic>
+#include <iomanip>
+
+// OccupancySnapshot implementation
+OccupancySnapshot::OccupancySnapshot() : version(0), slotCount(0), totals{{0, 0, 0}, 0, 0.0} {}
+
+uint64_t OccupancySnapshot::getVersion() const { return version; }
+size_t OccupancySnapshot::size() const { return slotCount; }
+const LotTotals& OccupancySnapshot::getTotals() const { return totals; }
+size_t OccupancySnapshot::chunkCount() const { return chunks.size(); }
+const OccupancySnapshot::Chunk* OccupancySnapshot::chunk(size_t index) const { return chunks[index].get(); }
+
+const SlotView& OccupancySnapshot::slot(size_t index) const {
+    return (*chunks[index / CHUNK_SLOTS])[index % CHUNK_SLOTS];
+}
+
+void OccupancySnapshot::printOccupation(std::ostream& os) const {
+    os << "\n=== Current Occupation ===\n";
+    for (size_t i = 0; i < slotCount; i++) {
+        const SlotView& view = slot(i);
+        os << "Slot " << view.id
+           << " (" << view.slotType
+           << ", Level " << view.level << "): ";
+        
+        if (view.occupied) {
+            os << "Occupied by " << view.vehicleTypeName
+               << " (" << view.plate << ")";
+        } else if (view.reserved) {
+            os << "Reserved for " << view.reservedFor;
+        } else {
+            os << "Available";
+        }
+        os << '\n';
+    }
+    os.flush(); // once, not per row
+}
+
+void OccupancySnapshot::printDailyReport(std::ostream& os) const {
+    os << "\n=== Daily Report ===\n";
+    os << "Total Vehicles: " << totals.closedTickets << std::endl;
+    os << "Motorcycles: " << totals.closedByType[static_cast<int>(VehicleType::MOTORCYCLE)] << std::endl;
+    os << "Cars: " << totals.closedByType[static_cast<int>(VehicleType::CAR)] << std::endl;
+    os << "EVs: " << totals.closedByType[static_cast<int>(VehicleType::EV)] << std::endl;
+    os << "Total Revenue: Rp " << std::fixed << std::setprecision(2) << totals.revenue << std::endl;
+    
+    // Utilization per floor
+    os << "\nUtilization per Floor:\n";
+    for (int floor = 1; floor <= 2; floor++) {
+        int occupied = 0;
+        int total = 0;
+        for (size_t i = 0; i < slotCount; i++) {
+            const SlotView& view = slot(i);
+            if (view.level == floor) {
+                total++;
+                if (view.occupied) occupied++;
+            }
+        }
+        double utilization = (total > 0) ? (occupied * 100.0 / total) : 0;
+        os << "Floor " << floor << ": " << std::setprecision(1) << utilization << "% ("
+           << occupied << "/" << total << " slots)" << std::endl;
+    }
+}
+
+// SnapshotPublisher implementation
+SnapshotPublisher::SnapshotPublisher() : current(std::make_shared<OccupancySnapshot>()), feed(nullptr) {}
+
+void SnapshotPublisher::setFeed(OccupancyFeed* occupancyFeed) { feed = occupancyFeed; }
+const OccupancyFeed* SnapshotPublisher::getFeed() const { return feed; }
+
+SlotView SnapshotPublisher::describe(const ParkingSlot& slot) {
+    SlotView view;
+    view.id = slot.getId();
+    view.slotType = slot.getSlotType();
+    view.level = slot.getLevel();
+    view.kind = slot.getKind();
+    view.occupied = slot.isOccupied();
+    view.reserved = false;
+    if (view.occupied) {
+        auto vehicle = slot.getVehicle();
+        view.vehicleTypeName = vehicle->getTypeName();
+        view.plate = vehicle->getPlate();
+    } else if (auto vip = dynamic_cast<const VIPSlot*>(&slot)) {
+        view.reserved = vip->isReserved();
+        if (view.reserved) view.reservedFor = vip->getReservedPlate();
+    }
+    return view;
+}
+
+std::shared_ptr<OccupancySnapshot> SnapshotPublisher::nextVersion() const {
+    // Only the writer thread stores, so a plain copy of its own last version is safe
+    auto next = std::make_shared<OccupancySnapshot>(*std::atomic_load(&current));
+    next->version++;
+    return next;
+}
+
+void SnapshotPublisher::replaceSlot(OccupancySnapshot& next, size_t index, const SlotView& view) {
+    size_t chunk = index / OccupancySnapshot::CHUNK_SLOTS;
+    auto copy = std::make_shared<OccupancySnapshot::Chunk>(*next.chunks[chunk]);
+    (*copy)[index % OccupancySnapshot::CHUNK_SLOTS] = view;
+    next.chunks[chunk] = copy;
+}
+
+void SnapshotPublisher::publish(std::shared_ptr<OccupancySnapshot> next, size_t changedSlot) {
+    std::atomic_store(&current, std::shared_ptr<const OccupancySnapshot>(next));
+    if (feed) {
+        // After the store, so a subscriber's baseline never misses a delta
+        const SlotView& view = next->slot(changedSlot);
+        OccupancyDelta delta = { next->version, static_cast<uint32_t>(changedSlot), static_cast<uint8_t>(view.level),
+                                 view.kind, OccupancyFeed::stateOf(view), 0 };
+        feed->publish(delta);
+    }
+}
+
+void SnapshotPublisher::attach(const std::vector<std::shared_ptr<ParkingSlot>>& slots) {
+    auto next = nextVersion();
+    next->chunks.clear();
+    slotIndex.clear();
+    for (size_t i = 0; i < slots.size(); i += OccupancySnapshot::CHUNK_SLOTS) {
+        auto chunk = std::make_shared<OccupancySnapshot::Chunk>();
+        for (size_t j = i; j < slots.size() && j < i + OccupancySnapshot::CHUNK_SLOTS; j++) {
+            chunk->push_back(describe(*slots[j]));
+            slotIndex[slots[j]->getId()] = j;
+        }
+        next->chunks.push_back(chunk);
+    }
+    next->slotCount = slots.size();
+    std::atomic_store(&current, std::shared_ptr<const OccupancySnapshot>(next));
+}
+
+void SnapshotPublisher::onPark(const ParkingSlot& slot) {
+    onSlotChanged(slot);
+}
+
+void SnapshotPublisher::onUnpark(const Ticket& ticket, const ParkingSlot& slot, double fee) {
+    auto found = slotIndex.find(slot.getId());
+    if (found == slotIndex.end()) return;
+    
+    // Slot release and the closed-ticket totals land in the same version
+    auto next = nextVersion();
+    replaceSlot(*next, found->second, describe(slot));
+    next->totals.closedByType[static_cast<int>(ticket.getVehicle()->getType())]++;
+    next->totals.closedTickets++;
+    next->totals.revenue += fee;
+    publish(next, found->second);
+}
+
+void SnapshotPublisher::onSlotChanged(const ParkingSlot& slot) {
+    auto found = slotIndex.find(slot.getId());
+    if (found == slotIndex.end()) return;
+    
+    auto next = nextVersion();
+    replaceSlot(*next, found->second, describe(slot));
+    publish(next, found->second);
+}
+
+void SnapshotPublisher::onReversal(double amount) {
+    // No slot changed, so nothing goes to the feed
+    auto next = nextVersion();
+    next->totals.revenue -= amount;
+    std::atomic_store(&current, std::shared_ptr<const OccupancySnapshot>(next));
+}
+
+std::shared_ptr<const OccupancySnapshot> SnapshotPublisher::read() const {
+    return std::atomic_load(&current);
+}
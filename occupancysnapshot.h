@@ -0,0 +1,100 @@
+#ifndef OCCUPANCYSNAPSHOT_H
+#define OCCUPANCYSNAPSHOT_H
+
+#include "ParkingSlot.h"
+#include "Ticket.h"
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class OccupancyFeed;
+
+struct SlotView {
+    std::string id;
+    std::string slotType;
+    int level;
+    SlotKind kind;
+    bool occupied;
+    bool reserved;
+    std::string reservedFor;
+    std::string vehicleTypeName;
+    std::string plate;
+};
+
+struct LotTotals {
+    long long closedByType[3]; // indexed by VehicleType
+    long long closedTickets;
+    double revenue;
+};
+
+// One immutable version of the lot as readers see it. Slots are stored in
+// fixed-size chunks shared between versions: a park or unpark copies only
+// the chunk holding its slot, every other chunk is reused by pointer.
+class OccupancySnapshot {
+public:
+    static const size_t CHUNK_SLOTS = 64;
+    typedef std::vector<SlotView> Chunk;
+    
+private:
+    uint64_t version;
+    size_t slotCount;
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    LotTotals totals;
+    
+    friend class SnapshotPublisher;
+    
+public:
+    OccupancySnapshot();
+    
+    uint64_t getVersion() const;
+    size_t size() const;
+    const SlotView& slot(size_t index) const;
+    // Chunks unchanged since an older version are the same pointer, which
+    // lets a reader holding that version find changed slots cheaply
+    size_t chunkCount() const;
+    const Chunk* chunk(size_t index) const;
+    const LotTotals& getTotals() const;
+    
+    void printOccupation(std::ostream& os) const;
+    void printDailyReport(std::ostream& os) const;
+};
+
+// Keeps the published snapshot in step with the lot. Only the lot's own
+// thread calls the update methods; each builds the next version off to the
+// side and publishes it with a single atomic pointer swap, so readers on
+// any thread get either the old or the new version, never a partial one.
+// Old versions are freed when their last reader drops the shared_ptr.
+class SnapshotPublisher {
+private:
+    std::shared_ptr<const OccupancySnapshot> current; // only touched via std::atomic_load/store
+    std::unordered_map<std::string, size_t> slotIndex;
+    OccupancyFeed* feed;
+    
+    std::shared_ptr<OccupancySnapshot> nextVersion() const;
+    void publish(std::shared_ptr<OccupancySnapshot> next, size_t changedSlot);
+    static SlotView describe(const ParkingSlot& slot);
+    static void replaceSlot(OccupancySnapshot& next, size_t index, const SlotView& view);
+    
+public:
+    SnapshotPublisher();
+    
+    void attach(const std::vector<std::shared_ptr<ParkingSlot>>& slots);
+    
+    void onPark(const ParkingSlot& slot);
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, double fee);
+    void onSlotChanged(const ParkingSlot& slot); // reservations
+    void onReversal(double amount);              // failed card charge
+    
+    // Each new version also appends the changed slot to the feed
+    void setFeed(OccupancyFeed* occupancyFeed);
+    const OccupancyFeed* getFeed() const;
+    
+    // Safe from any thread; never waits for the lot
+    std::shared_ptr<const OccupancySnapshot> read() const;
+};
+
+#endif
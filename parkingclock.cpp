@@ -0,0 +1,20 @@
+#include "ParkingClock.h"
+
+namespace {
+    thread_local VirtualClock* activeClock = nullptr;
+}
+
+time_t ParkingClock::now() {
+    return activeClock ? activeClock->now() : time(0);
+}
+
+VirtualClock::VirtualClock(time_t start) : current(start), previous(activeClock) {
+    activeClock = this;
+}
+
+VirtualClock::~VirtualClock() {
+    activeClock = previous;
+}
+
+void VirtualClock::set(time_t when) { current = when; }
+time_t VirtualClock::now() const { return current; }
@@ -0,0 +1,30 @@
+#ifndef PARKINGCLOCK_H
+#define PARKINGCLOCK_H
+
+#include <ctime>
+
+// Time source for tickets, slots and the lot. Reads the wall clock unless a
+// VirtualClock is active on the calling thread, so simulations can replay
+// recorded days on several threads at once.
+namespace ParkingClock {
+    time_t now();
+}
+
+// Overrides ParkingClock::now() for the current thread while in scope.
+// Nests: the previous clock is restored on destruction.
+class VirtualClock {
+private:
+    time_t current;
+    VirtualClock* previous;
+    
+public:
+    explicit VirtualClock(time_t start);
+    ~VirtualClock();
+    VirtualClock(const VirtualClock&) = delete;
+    VirtualClock& operator=(const VirtualClock&) = delete;
+    
+    void set(time_t when);
+    time_t now() const;
+};
+
+#endif
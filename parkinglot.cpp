@@ -1,9 +1,54 @@
 #include "ParkingLot.h"
+#include "ConfigParking.h"
+#include "ParkingClock.h"
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <algorithm>
+#include <climits>
+#include <cmath>
 
-ParkingLot::ParkingLot() {
+ParkingLot::ParkingLot() 
+    : pricing(nullptr), charging(nullptr), allocation(nullptr), members(nullptr), forecaster(nullptr), waitlist(nullptr), shardId(-1), nextTicketSeq(0),
+      epoch(0), epochPaymentStart(0), enforceHours(SystemConfig::ENFORCE_OPERATING_HOURS) {
+    initSlots();
+    snapshots.attach(slots);
+}
+
+ParkingLot::ParkingLot(int shard) 
+    : pricing(nullptr), charging(nullptr), allocation(nullptr), members(nullptr), forecaster(nullptr), waitlist(nullptr), shardId(checkedShard(shard)), nextTicketSeq(0),
+      epoch(0), epochPaymentStart(0), enforceHours(SystemConfig::ENFORCE_OPERATING_HOURS) {
+    initSlots();
+    snapshots.attach(slots);
+}
+
+#ifndef PARKING_STATIC_LAYOUT
+ParkingLot::ParkingLot(int shard, const std::vector<ParkingLayout::SlotDefinition>& layout)
+    : pricing(nullptr), charging(nullptr), allocation(nullptr), members(nullptr), forecaster(nullptr), waitlist(nullptr), shardId(checkedShard(shard)), nextTicketSeq(0),
+      epoch(0), epochPaymentStart(0), enforceHours(SystemConfig::ENFORCE_OPERATING_HOURS) {
+    for (const auto& def : layout) {
+        if (!def.isActive) continue;
+        if (def.type == "EV") {
+            slots.push_back(std::make_shared<EVSlot>(def.id, def.level));
+        } else if (def.type == "VIP") {
+            slots.push_back(std::make_shared<VIPSlot>(def.id, def.level));
+        } else {
+            slots.push_back(std::make_shared<RegularSlot>(def.id, def.level));
+        }
+    }
+    snapshots.attach(slots);
+}
+#endif
+
+void ParkingLot::initSlots() {
+#ifdef PARKING_STATIC_LAYOUT
+    // Fixed layout: slots live in slotStore; the aliasing shared_ptrs share
+    // no control block, so the only allocation is the pointer table itself
+    slots.reserve(StaticLayout::SLOT_COUNT);
+    for (size_t i = 0; i < StaticLayout::SLOT_COUNT; i++) {
+        slots.push_back(std::shared_ptr<ParkingSlot>(std::shared_ptr<ParkingSlot>(), &slotStore.at(i)));
+    }
+#else
     // Initialize some slots
     slots.push_back(std::make_shared<RegularSlot>("R1", 1));
     slots.push_back(std::make_shared<RegularSlot>("R2", 1));
@@ -11,28 +56,205 @@ ParkingLot::ParkingLot() {
     slots.push_back(std::make_shared<EVSlot>("E2", 1));
     slots.push_back(std::make_shared<VIPSlot>("V1", 2));
     slots.push_back(std::make_shared<VIPSlot>("V2", 2));
+#endif
+}
+
+int ParkingLot::getShardId() const { return shardId; }
+
+int ParkingLot::availableSlots(SlotKind kind) const {
+    int count = 0;
+#ifdef PARKING_STATIC_LAYOUT
+    size_t k = static_cast<size_t>(kind);
+    for (size_t p = StaticLayout::KIND_BEGIN[k]; p < StaticLayout::KIND_BEGIN[k + 1]; p++) {
+        if (!slots[StaticLayout::KIND_ORDER[p]]->isOccupied()) count++;
+    }
+#else
+    for (const auto& slot : slots) {
+        if (slot->getKind() == kind && !slot->isOccupied()) count++;
+    }
+#endif
+    return count;
+}
+
+int ParkingLot::maxShards() {
+    // The last sequence number of the last shard must still fit in an int
+    return INT_MAX / SystemConfig::SHARD_TICKET_ID_STRIDE - 1;
+}
+
+int ParkingLot::checkedShard(int shard) {
+    if (shard >= maxShards()) {
+        throw ParkingException("Shard " + std::to_string(shard) + " exceeds the ticket id range ("
+                               + std::to_string(maxShards()) + " shards)");
+    }
+    return shard;
+}
+
+int ParkingLot::shardOfTicket(int ticketId) {
+    return ticketId / SystemConfig::SHARD_TICKET_ID_STRIDE - 1;
+}
+
+bool ParkingLot::isOpenAt(time_t when) {
+    std::tm local = *std::localtime(&when);
+    return local.tm_hour >= SystemConfig::OPENING_HOUR && local.tm_hour < SystemConfig::CLOSING_HOUR;
+}
+
+void ParkingLot::setEnforceOperatingHours(bool enforce) { enforceHours = enforce; }
+
+int ParkingLot::getEpoch() const { return epoch; }
+
+SettlementSnapshot ParkingLot::closeEpoch(time_t closeTime) {
+    SettlementSnapshot snapshot;
+    snapshot.epoch = epoch;
+    snapshot.closeTime = closeTime;
+    snapshot.closedTickets = 0;
+    snapshot.revenue = 0;
+    for (size_t i = epochPaymentStart; i < payments.size(); i++) {
+        if (payments[i].second >= 0) snapshot.closedTickets++; // not a reversal
+        snapshot.revenue += payments[i].second;
+    }
+    
+    if (charging) {
+        charging->advance(closeTime);
+    }
+    for (const auto& ticket : tickets) {
+        if (ticket->isPaid()) continue;
+        double rate, flat;
+        ticket->getTariff(rate, flat);
+        // Energy delivered up to closing is owed even if the session
+        // continues; priced like ChargingScheduler::settle, after any discount
+        double energy = charging
+            ? std::round(charging->deliveredAt(ticket->getId(), closeTime) * ChargingConfig::ENERGY_RATE_PER_KWH)
+            : 0.0;
+        snapshot.addOpenTicket(ticket->getId(), ticket->getEntryTime(), rate, flat, energy,
+                               static_cast<uint8_t>(ticket->getVehicle()->getType()));
+    }
+    
+    epoch++;
+    epochPaymentStart = payments.size();
+    return snapshot;
+}
+
+void ParkingLot::addObserver(ParkingObserver* observer) {
+    observers.push_back(observer);
+}
+
+void ParkingLot::removeObserver(ParkingObserver* observer) {
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+void ParkingLot::setPricingEngine(PricingEngine* engine) {
+    if (pricing) {
+        removeObserver(pricing);
+    }
+    pricing = engine;
+    if (pricing) {
+        for (const auto& slot : slots) {
+            pricing->registerSlot(*slot);
+        }
+        addObserver(pricing);
+    }
+}
+
+void ParkingLot::setChargingScheduler(ChargingScheduler* scheduler) {
+    if (charging) {
+        removeObserver(charging);
+    }
+    charging = scheduler;
+    if (charging) {
+        addObserver(charging);
+    }
+}
+
+void ParkingLot::setAllocationPolicy(AllocationPolicy* policy) {
+    if (allocation) {
+        removeObserver(allocation);
+    }
+    allocation = policy;
+    if (allocation) {
+        allocation->attach(slots);
+        addObserver(allocation);
+    }
+}
+
+void ParkingLot::setMemberRegistry(const MemberRegistry* registry) {
+    members = registry;
+}
+
+void ParkingLot::setForecaster(OccupancyForecaster* model) {
+    if (forecaster) {
+        removeObserver(forecaster);
+    }
+    forecaster = model;
+    if (forecaster) {
+        for (const auto& slot : slots) {
+            forecaster->registerSlot(*slot);
+        }
+        addObserver(forecaster);
+    }
+}
+
+void ParkingLot::setWaitlist(Waitlist* list) {
+    waitlist = list;
 }
 
 ParkingSlot* ParkingLot::findAvailableSlot(const Vehicle& v) {
+    if (allocation) {
+        return allocation->select(v);
+    }
+#ifdef PARKING_STATIC_LAYOUT
+    for (size_t i = 0; i < StaticLayout::SLOT_COUNT; i++) {
+        ParkingSlot& slot = *slots[i];
+        if (!slot.isOccupied() && slot.fits(v) && slot.canPark(v)) {
+            return &slot;
+        }
+    }
+#else
     for (auto& slot : slots) {
-        if (!slot->isOccupied() && slot->canPark(v)) {
+        if (!slot->isOccupied() && slot->fits(v) && slot->canPark(v)) {
             return slot.get();
         }
     }
+#endif
     return nullptr;
 }
 
+std::shared_ptr<Ticket> ParkingLot::parkInto(ParkingSlot& slot, std::shared_ptr<Vehicle> v) {
+    if (shardId >= 0 && nextTicketSeq >= SystemConfig::SHARD_TICKET_ID_STRIDE) {
+        // Further ids would fall into the next shard's range
+        throw ParkingException("Ticket ids exhausted for shard " + std::to_string(shardId));
+    }
+    slot.parkVehicle(v);
+    auto ticket = shardId < 0
+        ? std::make_shared<Ticket>(slot.getId(), v)
+        : std::make_shared<Ticket>((shardId + 1) * SystemConfig::SHARD_TICKET_ID_STRIDE + nextTicketSeq++,
+                                   slot.getId(), v);
+    if (pricing) {
+        // Quote before observers count this vehicle in the utilization
+        ticket->setHourlyRate(pricing->quote(slot.getLevel(), slot.getKind(), v->getType()));
+    }
+    if (members && members->isMember(v->getPlate())) {
+        ticket->setMember(true);
+    }
+    ticketIndex[ticket->getId()] = tickets.size();
+    tickets.push_back(ticket);
+    snapshots.onPark(slot);
+    for (auto observer : observers) {
+        observer->onPark(*ticket, slot, ticket->getEntryTime());
+    }
+    return ticket;
+}
+
 std::shared_ptr<Ticket> ParkingLot::parkVehicle(std::shared_ptr<Vehicle> v) {
+    if (enforceHours && !isOpenAt(ParkingClock::now())) {
+        throw ParkingException(Messages::ERROR_CLOSED);
+    }
     ParkingSlot* slot = findAvailableSlot(*v);
     if (!slot) {
         throw NoAvailableSlotException();
     }
     
     try {
-        slot->parkVehicle(v);
-        auto ticket = std::make_shared<Ticket>(slot->getId(), v);
-        tickets.push_back(ticket);
-        return ticket;
+        return parkInto(*slot, v);
     } catch (const ParkingException& e) {
         // Demonstrating rethrow
         std::cout << "Error in parkVehicle, rethrowing..." << std::endl;
@@ -40,13 +262,62 @@ std::shared_ptr<Ticket> ParkingLot::parkVehicle(std::shared_ptr<Vehicle> v) {
     }
 }
 
+ParkingLot::Admission ParkingLot::parkOrWait(std::shared_ptr<Vehicle> v) {
+    if (enforceHours && !isOpenAt(ParkingClock::now())) {
+        throw ParkingException(Messages::ERROR_CLOSED);
+    }
+    ParkingSlot* slot = findAvailableSlot(*v);
+    if (slot) {
+        return Admission{ parkInto(*slot, v), 0 };
+    }
+    if (!waitlist) {
+        throw NoAvailableSlotException();
+    }
+    WaitClass waitClass = Waitlist::classify(*v, holdsVipReservation(v->getPlate()));
+    return Admission{ nullptr, waitlist->enqueue(v, waitClass, ParkingClock::now()) };
+}
+
+bool ParkingLot::holdsVipReservation(const std::string& plate) const {
+    for (const auto& slot : slots) {
+        auto vipSlot = std::dynamic_pointer_cast<VIPSlot>(slot);
+        if (vipSlot && vipSlot->isReserved() && vipSlot->getReservedPlate() == plate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParkingLot::assignWaiting(ParkingSlot& slot) {
+    if (!waitlist || waitlist->size() == 0 || (enforceHours && !isOpenAt(ParkingClock::now()))
+        || (shardId >= 0 && nextTicketSeq >= SystemConfig::SHARD_TICKET_ID_STRIDE)) {
+        return;
+    }
+    int waitId = waitlist->next(slot);
+    if (waitId < 0) {
+        return;
+    }
+    auto ticket = parkInto(slot, waitlist->vehicleOf(waitId));
+    waitlist->assigned(waitId, ticket->getId(), ticket->getEntryTime());
+    std::cout << "Waiting vehicle " << ticket->getVehicle()->getPlate() << " (wait #" << waitId
+              << ") assigned to slot " << slot.getId() << ", ticket " << ticket->getId() << std::endl;
+}
+
 double ParkingLot::unparkVehicle(int ticketId) {
-    for (size_t i = 0; i < tickets.size(); i++) {
-        if (tickets[i]->getId() == ticketId && !tickets[i]->isPaid()) {
-            time_t exitTime = time(0);
+    auto found = ticketIndex.find(ticketId);
+    if (found != ticketIndex.end()) {
+        size_t i = found->second;
+        if (!tickets[i]->isPaid()) {
+            time_t exitTime = ParkingClock::now();
+            if (members && !tickets[i]->isMember() && members->isMember(tickets[i]->getVehicle()->getPlate())) {
+                tickets[i]->setMember(true); // joined during the stay
+            }
             double fee = tickets[i]->calculateFee(exitTime);
+            if (charging) {
+                fee += charging->settle(ticketId, exitTime);
+            }
             
             // Find the slot and unpark
+            ParkingSlot* freed = nullptr;
             for (auto& slot : slots) {
                 if (slot->getId() == tickets[i]->getSlotId()) {
                     slot->unparkVehicle();
@@ -56,23 +327,52 @@ double ParkingLot::unparkVehicle(int ticketId) {
                     if (vipSlot && vipSlot->isReserved()) {
                         vipSlot->clearReservation();
                     }
+                    
+                    snapshots.onUnpark(*tickets[i], *slot, fee);
+                    for (auto observer : observers) {
+                        observer->onUnpark(*tickets[i], *slot, exitTime, fee);
+                    }
+                    freed = slot.get();
                     break;
                 }
             }
             
             tickets[i]->markPaid();
             payments.push_back({exitTime, fee});
+            if (freed) {
+                assignWaiting(*freed);
+            }
             return fee;
         }
     }
     throw InvalidTicketException();
 }
 
+void ParkingLot::reverseCharge(int ticketId, double amount) {
+    auto found = ticketIndex.find(ticketId);
+    if (found == ticketIndex.end() || !tickets[found->second]->isPaid()) {
+        throw InvalidTicketException();
+    }
+    const Ticket& ticket = *tickets[found->second];
+    time_t when = ParkingClock::now();
+    payments.push_back({when, -amount});
+    snapshots.onReversal(amount);
+    for (auto& slot : slots) {
+        if (slot->getId() == ticket.getSlotId()) {
+            for (auto observer : observers) {
+                observer->onChargeReversed(ticket, *slot, when, amount);
+            }
+            break;
+        }
+    }
+}
+
 void ParkingLot::reserveVIP(const std::string& plate, int durationHours) {
     for (auto& slot : slots) {
         auto vipSlot = std::dynamic_pointer_cast<VIPSlot>(slot);
         if (vipSlot && !vipSlot->isOccupied() && !vipSlot->isReserved()) {
             vipSlot->reserve(plate, durationHours);
+            snapshots.onSlotChanged(*vipSlot);
             std::cout << "VIP slot " << vipSlot->getId() << " reserved for " << plate << std::endl;
             return;
         }
@@ -80,75 +380,74 @@ void ParkingLot::reserveVIP(const std::string& plate, int durationHours) {
     throw ReservationException();
 }
 
-void ParkingLot::showOccupation() const {
-    std::cout << "\n=== Current Occupation ===\n";
-    for (const auto& slot : slots) {
-        std::cout << "Slot " << slot->getId() 
-                  << " (" << slot->getSlotType() 
-                  << ", Level " << slot->getLevel() << "): ";
-        
-        if (slot->isOccupied()) {
-            auto vehicle = slot->getVehicle();
-            std::cout << "Occupied by " << vehicle->getTypeName()
-                      << " (" << vehicle->getPlate() << ")";
-        } else if (auto vipSlot = std::dynamic_pointer_cast<VIPSlot>(slot)) {
-            if (vipSlot->isReserved()) {
-                std::cout << "Reserved for " << vipSlot->getId();
-            } else {
-                std::cout << "Available";
-            }
-        } else {
-            std::cout << "Available";
-        }
-        std::cout << std::endl;
+std::shared_ptr<const OccupancySnapshot> ParkingLot::snapshot() const {
+    return snapshots.read();
+}
+
+void ParkingLot::setOccupancyFeed(OccupancyFeed* feed) {
+    snapshots.setFeed(feed);
+}
+
+FeedCursor ParkingLot::subscribeOccupancy() const {
+    if (!snapshots.getFeed()) {
+        throw ParkingException("Occupancy feed is not enabled");
     }
+    return FeedCursor(*snapshots.getFeed(), snapshots);
+}
+
+void ParkingLot::showOccupation() const {
+    snapshots.read()->printOccupation(std::cout);
 }
 
 void ParkingLot::generateDailyReport() const {
-    std::cout << "\n=== Daily Report ===\n";
-    
-    int totalVehicles = 0;
-    int motorcycleCount = 0;
-    int carCount = 0;
-    int evCount = 0;
-    double totalRevenue = 0;
-    
-    for (const auto& payment : payments) {
-        totalRevenue += payment.second;
+    snapshots.read()->printDailyReport(std::cout);
+}
+
+void ParkingLot::showForecast() const {
+    if (!forecaster) {
+        std::cout << "Forecasting is not enabled" << std::endl;
+        return;
     }
-    
+    forecaster->printForecast(std::cout, ParkingClock::now());
+}
+
+void ParkingLot::showWaitlist() const {
+    if (!waitlist) {
+        std::cout << "Waitlist is not enabled" << std::endl;
+        return;
+    }
+    Waitlist::Stats stats = waitlist->getStats();
+    std::cout << "\n=== WAITLIST ===" << std::endl;
+    std::cout << "Waiting - EV charging: " << stats.waiting[0] << ", VIP: " << stats.waiting[1]
+              << ", Regular: " << stats.waiting[2] << std::endl;
+    std::cout << "Enqueued: " << stats.enqueued << ", assigned: " << stats.assigned
+              << ", cancelled: " << stats.cancelled << ", longest queue: " << stats.longestQueue << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "Wait time - average: " << stats.averageWaitSeconds / 60 << " min, max: "
+              << stats.maxWaitSeconds / 60 << " min" << std::endl;
+}
+
+void ParkingLot::exportTickets(std::ostream& os, ExportFormat format) const {
+    ReportExporter exporter(os, format);
+    exporter.writeTicketHeader();
     for (const auto& ticket : tickets) {
-        if (ticket->isPaid()) {
-            totalVehicles++;
-            auto vehicle = ticket->getVehicle();
-            switch(vehicle->getType()) {
-                case VehicleType::MOTORCYCLE: motorcycleCount++; break;
-                case VehicleType::CAR: carCount++; break;
-                case VehicleType::EV: evCount++; break;
-            }
-        }
+        exporter.writeTicket(*ticket);
     }
-    
-    std::cout << "Total Vehicles: " << totalVehicles << std::endl;
-    std::cout << "Motorcycles: " << motorcycleCount << std::endl;
-    std::cout << "Cars: " << carCount << std::endl;
-    std::cout << "EVs: " << evCount << std::endl;
-    std::cout << "Total Revenue: Rp " << std::fixed << std::setprecision(2) << totalRevenue << std::endl;
-    
-    // Utilization per floor
-    std::cout << "\nUtilization per Floor:\n";
-    for (int floor = 1; floor <= 2; floor++) {
-        int occupied = 0;
-        int total = 0;
-        for (const auto& slot : slots) {
-            if (slot->getLevel() == floor) {
-                total++;
-                if (slot->isOccupied()) occupied++;
-            }
-        }
-        double utilization = (total > 0) ? (occupied * 100.0 / total) : 0;
-        std::cout << "Floor " << floor << ": " << std::setprecision(1) << utilization << "% (" 
-                  << occupied << "/" << total << " slots)" << std::endl;
+}
+
+void ParkingLot::exportPayments(std::ostream& os, ExportFormat format) const {
+    ReportExporter exporter(os, format);
+    exporter.writePaymentHeader();
+    for (const auto& payment : payments) {
+        exporter.writePayment(payment.first, payment.second);
+    }
+}
+
+void ParkingLot::exportOccupation(std::ostream& os, ExportFormat format) const {
+    ReportExporter exporter(os, format);
+    exporter.writeSlotHeader();
+    for (const auto& slot : slots) {
+        exporter.writeSlot(*slot);
     }
 }
 
@@ -4,26 +4,129 @@
 #include "ParkingSlot.h"
 #include "Ticket.h"
 #include "Exceptions.h"
+#include "ReportExporter.h"
+#include "ParkingObserver.h"
+#include "PricingEngine.h"
+#include "ChargingScheduler.h"
+#include "OccupancyForecast.h"
+#include "AllocationPolicy.h"
+#include "MemberRegistry.h"
+#include "Settlement.h"
+#include "ConfigParking.h"
+#include "OccupancySnapshot.h"
+#include "OccupancyFeed.h"
+#include "Waitlist.h"
+#ifdef PARKING_STATIC_LAYOUT
+#include "StaticLayout.h"
+#endif
 #include <vector>
 #include <memory>
 #include <utility>
+#include <ostream>
+#include <unordered_map>
 
 class ParkingLot {
 private:
+#ifdef PARKING_STATIC_LAYOUT
+    StaticSlotStore slotStore; // slots below are non-owning views into this
+#endif
     std::vector<std::shared_ptr<ParkingSlot>> slots;
     std::vector<std::shared_ptr<Ticket>> tickets;
-    std::vector<std::pair<time_t, double>> payments;
+    std::unordered_map<int, size_t> ticketIndex; // ticket id -> position in tickets
+    std::vector<std::pair<time_t, double>> payments; // a reversed charge adds a negative entry
+    std::vector<ParkingObserver*> observers;
+    PricingEngine* pricing;
+    ChargingScheduler* charging;
+    AllocationPolicy* allocation;
+    const MemberRegistry* members;
+    OccupancyForecaster* forecaster;
+    Waitlist* waitlist;
+    int shardId;        // -1 = standalone lot using the global ticket counter
+    int nextTicketSeq;
+    int epoch;                  // business day, advanced by closeEpoch()
+    size_t epochPaymentStart;   // first entry of payments in the current epoch
+    bool enforceHours;
+    SnapshotPublisher snapshots;
     
+    void initSlots();
     ParkingSlot* findAvailableSlot(const Vehicle& v);
+    std::shared_ptr<Ticket> parkInto(ParkingSlot& slot, std::shared_ptr<Vehicle> v);
+    bool holdsVipReservation(const std::string& plate) const;
+    void assignWaiting(ParkingSlot& slot);
+    static int checkedShard(int shard);
     
 public:
+    // Result of parkOrWait: a ticket, or a place on the waitlist
+    struct Admission {
+        std::shared_ptr<Ticket> ticket;
+        int waitId; // 0 when parked
+    };
+    
     ParkingLot();
+    explicit ParkingLot(int shard);
+#ifndef PARKING_STATIC_LAYOUT
+    // Lot with the given slots instead of the built-in ones; inactive
+    // definitions are skipped. Used to simulate candidate layouts.
+    ParkingLot(int shard, const std::vector<ParkingLayout::SlotDefinition>& layout);
+#endif
+    
+    int getShardId() const;
+    int availableSlots(SlotKind kind) const;
+    static int shardOfTicket(int ticketId);
+    // Shard ids 0 .. maxShards() - 1 keep every ticket id within int
+    static int maxShards();
+    
+    // Entries are refused outside OPENING_HOUR..CLOSING_HOUR; exits never are
+    static bool isOpenAt(time_t when);
+    void setEnforceOperatingHours(bool enforce);
+    
+    int getEpoch() const;
+    // Copies the open tickets and the epoch's closed totals for settlement,
+    // then starts the next epoch. O(tickets); the pricing happens elsewhere.
+    SettlementSnapshot closeEpoch(time_t closeTime);
+    
+    void addObserver(ParkingObserver* observer);
+    void removeObserver(ParkingObserver* observer);
+    
+    // Enables dynamic pricing; the engine is registered as an observer
+    void setPricingEngine(PricingEngine* engine);
+    // Enables EV charging sessions billed by delivered energy
+    void setChargingScheduler(ChargingScheduler* scheduler);
+    // Replaces first-fit slot search; null restores first-fit
+    void setAllocationPolicy(AllocationPolicy* policy);
+    // Member plates get the member discount; checked at entry and exit
+    void setMemberRegistry(const MemberRegistry* registry);
+    // Feeds park/unpark events into per-floor, per-kind occupancy forecasts
+    void setForecaster(OccupancyForecaster* model);
+    // Full-lot arrivals can queue; freed slots go to the best waiting vehicle
+    void setWaitlist(Waitlist* list);
     
     std::shared_ptr<Ticket> parkVehicle(std::shared_ptr<Vehicle> v);
+    // Like parkVehicle, but queues the vehicle instead of throwing
+    // NoAvailableSlotException when a waitlist is set
+    Admission parkOrWait(std::shared_ptr<Vehicle> v);
+    void showWaitlist() const;
     double unparkVehicle(int ticketId);
+    // Takes a failed card charge of a closed ticket back out of revenue:
+    // payments, the published totals and the observers' records. Throws
+    // InvalidTicketException if the ticket is unknown or still open.
+    void reverseCharge(int ticketId, double amount);
     void reserveVIP(const std::string& plate, int durationHours);
+    
+    // Latest published version of occupancy and totals; safe to call from
+    // any thread while gates keep parking
+    std::shared_ptr<const OccupancySnapshot> snapshot() const;
+    // Appends a delta to the feed for every slot change; set before gates start
+    void setOccupancyFeed(OccupancyFeed* feed);
+    // Cursor at the head of the feed with the current snapshot as baseline;
+    // safe from any thread
+    FeedCursor subscribeOccupancy() const;
     void showOccupation() const;
     void generateDailyReport() const;
+    void showForecast() const;
+    void exportTickets(std::ostream& os, ExportFormat format) const;
+    void exportPayments(std::ostream& os, ExportFormat format) const;
+    void exportOccupation(std::ostream& os, ExportFormat format) const;
     void saveTestData();
 };
 
@@ -0,0 +1,20 @@
+#ifndef PARKINGOBSERVER_H
+#define PARKINGOBSERVER_H
+
+#include "ParkingSlot.h"
+#include "Ticket.h"
+#include <ctime>
+
+// Receives park/unpark events from ParkingLot. Observers are not owned by the
+// lot and must outlive it (or be removed) and must not throw.
+class ParkingObserver {
+public:
+    virtual ~ParkingObserver() {}
+    
+    virtual void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {}
+    virtual void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {}
+    // A charge reported by onUnpark failed; amount is taken back out of revenue
+    virtual void onChargeReversed(const Ticket& ticket, const ParkingSlot& slot, time_t when, double amount) {}
+};
+
+#endif
@@ -1,48 +1,127 @@
 #include "ParkingSystemUI.h"
+#include "ConfigParking.h"
+#include "ReportEngine.h"
 #include <iostream>
-#include <iomanop>
+#include <iomanip>
 #include <string>
+#include <fstream>
+#include <ctime>
+#include <limits>
+
+ParkingSystemUI::ParkingSystemUI()
+    : history(SystemConfig::PAYMENT_HISTORY_DIR, SystemConfig::PAYMENT_HISTORY_COMMIT_ROWS),
+      charging(ChargingConfig::SITE_POWER_BUDGET_KW, ChargingConfig::STATION_MAX_POWER_KW),
+      gateway(PaymentConfig::MOCK_GATEWAY_LATENCY_MS, PaymentConfig::MOCK_GATEWAY_TRANSIENT_RATE,
+              PaymentConfig::MOCK_GATEWAY_DECLINE_RATE),
+      payments(gateway, PaymentConfig::GATEWAY_BATCH_SIZE, PaymentConfig::GATEWAY_FLUSH_INTERVAL_MS,
+               PaymentConfig::MAX_PAYMENT_ATTEMPTS, PaymentConfig::RETRY_BACKOFF_MS),
+      plates(static_cast<time_t>(SystemConfig::FUZZY_RECENT_HOURS) * 3600),
+      dialogs{lot, lotMutex, &members, PaymentConfig::ENABLE_CARD_PAYMENT ? &payments : nullptr, true} {
+    lot.addObserver(&history);
+    lot.addObserver(&rollup);
+    lot.addObserver(&plates);
+    try {
+        stays.reset(new StayIndex(SystemConfig::STAY_INDEX_DIR, SystemConfig::STAY_MEMTABLE_RECORDS,
+                                  SystemConfig::STAY_BLOCK_RECORDS, SystemConfig::STAY_COMPACTION_FANIN));
+        lot.addObserver(stays.get());
+    } catch (const std::exception& e) {
+        // Unreadable directory or damaged run: the rest of the console still works
+        std::cout << "Stay history disabled: " << e.what() << std::endl;
+    }
+    lot.setForecaster(&forecaster);
+    lot.addObserver(&payments);
+    if (SystemConfig::ENABLE_DYNAMIC_PRICING) {
+        lot.setPricingEngine(&pricing);
+    }
+    if (SystemConfig::ENABLE_EV_CHARGING) {
+        lot.setChargingScheduler(&charging);
+    }
+    
+    if (SystemConfig::ALLOCATION_POLICY == "NEAREST_ENTRANCE") {
+        allocation.reset(new NearestEntrancePolicy());
+    } else if (SystemConfig::ALLOCATION_POLICY == "FLOOR_BY_FLOOR") {
+        allocation.reset(new FloorByFloorPolicy());
+    } else if (SystemConfig::ALLOCATION_POLICY == "SPREAD_FLOORS") {
+        allocation.reset(new SpreadFloorsPolicy());
+    }
+    lot.setAllocationPolicy(allocation.get());
+    
+    if (SystemConfig::ENABLE_MEMBER_DISCOUNT) {
+        try {
+            members.reload(SystemConfig::MEMBER_REGISTRY_FILE);
+        } catch (const ParkingException&) {
+            // No member file yet: everyone pays the regular tariff
+        }
+        lot.setMemberRegistry(&members);
+    }
+    if (SystemConfig::ENABLE_WAITLIST) {
+        lot.setWaitlist(&waitlist);
+    }
+}
+
+void ParkingSystemUI::runDialog(SessionTask dialog) {
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // rest of the menu line
+    try {
+        dialog.runToCompletion();
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    } catch (...) {
+        std::cout << "Unknown error occurred!" << std::endl;
+    }
+}
 
 void ParkingSystemUI::registerAndPark() {
+    runDialog(GateDialogs::registerAndPark(console, dialogs));
+}
+
+void ParkingSystemUI::unparkVehicle() {
+    runDialog(GateDialogs::unparkVehicle(console, dialogs));
+}
+
+void ParkingSystemUI::reserveVIP() {
+    runDialog(GateDialogs::reserveVIP(console, dialogs));
+}
+
+void ParkingSystemUI::exportData() {
     try {
-        std::string plate, owner;
-        int typeChoice;
-        bool charging = false;
+        std::string prefix;
+        int formatChoice;
         
-        std::cout << "\nEnter vehicle plate: ";
-        std::cin.ignore(); // Clear buffer
-        std::getline(std::cin, plate);
-        std::cout << "Enter owner name: ";
-        std::getline(std::cin, owner);
+        std::cout << "\nEnter export file prefix: ";
+        std::cin.ignore();
+        std::getline(std::cin, prefix);
+        std::cout << "Format:\n1. CSV\n2. JSON lines\nChoice: ";
+        std::cin >> formatChoice;
         
-        std::cout << "Vehicle type:\n1. Motorcycle\n2. Car\n3. EV\nChoice: ";
-        std::cin >> typeChoice;
+        ExportFormat format = (formatChoice == 2) ? ExportFormat::JSON_LINES : ExportFormat::CSV;
+        const char* ext = (format == ExportFormat::CSV) ? ".csv" : ".jsonl";
         
-        std::shared_ptr<Vehicle> vehicle;
+        // Large buffer so each export is written in few, big chunks
+        std::vector<char> buffer(1 << 16);
         
-        switch(typeChoice) {
-            case 1:
-                vehicle = std::make_shared<Motorcycle>(plate, owner);
-                break;
-            case 2:
-                vehicle = std::make_shared<Car>(plate, owner);
-                break;
-            case 3:
-                std::cout << "Need charging? (1=Yes, 0=No): ";
-                int chargeChoice;
-                std::cin >> chargeChoice;
-                charging = (chargeChoice == 1);
-                vehicle = std::make_shared<EV>(plate, owner, charging);
-                break;
-            default:
-                std::cout << "Invalid choice!" << std::endl;
-                return;
-        }
+        std::ofstream ticketsOut;
+        ticketsOut.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        ticketsOut.open(prefix + "_tickets" + ext);
+        lot.exportTickets(ticketsOut, format);
+        ticketsOut.close();
+        
+        std::ofstream paymentsOut;
+        paymentsOut.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        paymentsOut.open(prefix + "_payments" + ext);
+        lot.exportPayments(paymentsOut, format);
+        paymentsOut.close();
         
-        auto ticket = lot.parkVehicle(vehicle);
-        std::cout << "Vehicle parked successfully!\n";
-        std::cout << "Ticket ID: " << ticket->getId() << std::endl;
+        std::ofstream slotsOut;
+        slotsOut.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        slotsOut.open(prefix + "_occupation" + ext);
+        lot.exportOccupation(slotsOut, format);
+        slotsOut.close();
         
+        if (!ticketsOut || !paymentsOut || !slotsOut) {
+            throw ParkingException("Failed to write export files");
+        }
+        std::cout << "Data exported with prefix " << prefix << std::endl;
+    
     } catch (const ParkingException& e) {
         std::cout << "Error: " << e.what() << std::endl;
     } catch (...) {
@@ -50,43 +129,236 @@ void ParkingSystemUI::registerAndPark() {
     }
 }
 
-void ParkingSystemUI::unparkVehicle() {
+void ParkingSystemUI::showRevenueHistory() {
+    int days;
+    std::cout << "\nNumber of days to include: ";
+    std::cin >> days;
+    
+    time_t to = time(0);
+    time_t from = to - static_cast<time_t>(days) * 24 * 3600;
+    
+    history.commit(); // include exits still in the write batch
+    std::cout << "\n=== Revenue History ===\n" << std::fixed << std::setprecision(2);
+    for (const auto& day : history.revenueByDay(from, to)) {
+        std::cout << day.first << ": Rp " << day.second << std::endl;
+    }
+    std::vector<double> byType = history.revenueByVehicleType(from, to);
+    std::cout << "Motorcycles: Rp " << byType[0] << std::endl;
+    std::cout << "Cars: Rp " << byType[1] << std::endl;
+    std::cout << "EVs: Rp " << byType[2] << std::endl;
+    std::vector<double> byFloor = history.revenueByFloor(from, to);
+    for (size_t floor = 1; floor < byFloor.size(); floor++) {
+        std::cout << "Floor " << floor << ": Rp " << byFloor[floor] << std::endl;
+    }
+    std::cout << "Total: Rp " << history.revenue(from, to) << std::endl;
+    
+    ReportEngine engine(pool);
+    ReportSummary summary;
+    try {
+        summary = engine.summarize(history, from, to);
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return;
+    }
+    std::cout << "Closed tickets: " << summary.closedTickets << std::endl;
+    std::cout << "Average stay: " << std::setprecision(1) << summary.averageStayHours() << " hours" << std::endl;
+    // Capacities of the lot as built, not the configured layout figures
+    int floorCapacity[3] = { 0, 0, 0 };
+    std::shared_ptr<const OccupancySnapshot> lotSnapshot = lot.snapshot();
+    for (size_t i = 0; i < lotSnapshot->size(); i++) {
+        int level = lotSnapshot->slot(i).level;
+        if (level >= 1 && level <= 2) floorCapacity[level]++;
+    }
+    for (int floor = 1; floor <= 2; floor++) {
+        std::cout << "Floor " << floor << " utilization: "
+                  << ReportEngine::utilization(summary, floor, floorCapacity[floor], from, to) << "%" << std::endl;
+    }
+}
+
+void ParkingSystemUI::showPeakOccupancy() {
+    const int days = 30;
+    time_t now = time(0);
+    
+    std::cout << "\n=== Peak Occupancy (last " << days << " days) ===\n";
+    for (int floor = 1; floor <= 2; floor++) {
+        int morning = rollup.peakInDailyWindow(ParkingRate::PEAK_MORNING_START_HOUR,
+                                               ParkingRate::PEAK_MORNING_END_HOUR, days, now, floor);
+        int evening = rollup.peakInDailyWindow(ParkingRate::PEAK_EVENING_START_HOUR,
+                                               ParkingRate::PEAK_EVENING_END_HOUR, days, now, floor);
+        OccupancyRollup::Totals today = rollup.query(now - 24 * 3600, now, floor);
+        std::cout << "Floor " << floor << ": now " << rollup.currentOccupancy(floor)
+                  << ", morning peak " << morning
+                  << ", evening peak " << evening
+                  << ", last 24h arrivals " << today.arrivals
+                  << ", exits " << today.exits << std::endl;
+    }
+}
+
+void ParkingSystemUI::showPriceBoard() {
+    const SlotKind kinds[] = { SlotKind::REGULAR, SlotKind::EV, SlotKind::VIP };
+    const char* kindNames[] = { "Regular", "EV", "VIP" };
+    
+    std::cout << "\n=== Current Hourly Rates ===\n" << std::fixed << std::setprecision(0);
+    for (int floor = 1; floor <= 2; floor++) {
+        for (int k = 0; k < 3; k++) {
+            if (pricing.utilization(floor, kinds[k]) >= 100.0) continue;
+            std::cout << "Floor " << floor << " " << kindNames[k]
+                      << ": Motorcycle Rp " << pricing.quote(floor, kinds[k], VehicleType::MOTORCYCLE)
+                      << ", Car Rp " << pricing.quote(floor, kinds[k], VehicleType::CAR)
+                      << ", EV Rp " << pricing.quote(floor, kinds[k], VehicleType::EV) << std::endl;
+        }
+    }
+}
+
+void ParkingSystemUI::reverseFailedCharges() {
+    for (const PaymentRequest& failed : payments.takeFailures()) {
+        lot.reverseCharge(failed.ticketId, failed.amount);
+        std::cout << "Card payment failed for ticket " << failed.ticketId << ", Rp "
+                  << std::fixed << std::setprecision(2) << failed.amount << " taken out of revenue" << std::endl;
+    }
+}
+
+void ParkingSystemUI::checkCardPayment() {
+    reverseFailedCharges();
+    
     try {
         int ticketId;
         std::cout << "\nEnter ticket ID: ";
         std::cin >> ticketId;
         
-        double fee = lot.unparkVehicle(ticketId);
-        std::cout << "Vehicle unparked successfully!\n";
-        std::cout << "Total fee: Rp " << std::fixed << std::setprecision(2) << fee << std::endl;
-        
+        std::cout << "Waiting for gateway..." << std::endl;
+        payments.confirm(ticketId);
+        std::cout << "Payment settled." << std::endl;
+    
+    } catch (const PaymentException& e) {
+        std::cout << "Error: " << Messages::ERROR_PAYMENT << std::endl;
+        reverseFailedCharges();
     } catch (const ParkingException& e) {
         std::cout << "Error: " << e.what() << std::endl;
-    } catch (...) {
-        std::cout << "Unknown error occurred!" << std::endl;
     }
 }
 
-void ParkingSystemUI::reserveVIP() {
+void ParkingSystemUI::closeDay() {
     try {
-        std::string plate;
-        int duration;
+        time_t now = time(0);
+        SettlementSnapshot snapshot = lot.closeEpoch(now);
         
-        std::cout << "\nEnter vehicle plate for reservation: ";
-        std::cin.ignore();
-        std::getline(std::cin, plate);
-        std::cout << "Enter reservation duration (hours): ";
-        std::cin >> duration;
-        
-        lot.reserveVIP(plate, duration);
+        SettlementJob job(pool, SystemConfig::DAILY_CLOSE_DIR);
+        DailyClose record = job.settle(snapshot);
+        closedDay = PaymentHistory::dayKey(now);
         
+        std::cout << "\n=== Daily Close (epoch " << record.epoch << ") ===\n" << std::fixed << std::setprecision(2);
+        std::cout << "Closed tickets: " << record.closedTickets << ", revenue Rp " << record.revenue << std::endl;
+        std::cout << "Open tickets: " << record.openTickets << ", overnight accrual Rp " << record.accrued << std::endl;
+    
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
+void ParkingSystemUI::closeDayIfDue() {
+    time_t now = time(0);
+    std::tm local = *std::localtime(&now);
+    if (local.tm_hour >= SystemConfig::CLOSING_HOUR && closedDay != PaymentHistory::dayKey(now)) {
+        closeDay();
+    }
+}
+
+void ParkingSystemUI::reloadMembers() {
+    try {
+        size_t count = members.reload(SystemConfig::MEMBER_REGISTRY_FILE);
+        std::cout << "Member list reloaded: " << count << " members" << std::endl;
     } catch (const ParkingException& e) {
         std::cout << "Error: " << e.what() << std::endl;
-    } catch (...) {
-        std::cout << "Unknown error occurred!" << std::endl;
     }
 }
 
+void ParkingSystemUI::checkWaitlist() {
+    lot.showWaitlist();
+    if (!SystemConfig::ENABLE_WAITLIST) {
+        return;
+    }
+    
+    int waitId;
+    std::cout << "Wait number to check (0 to skip): ";
+    std::cin >> waitId;
+    if (waitId == 0) {
+        return;
+    }
+    int ticketId = waitlist.ticketFor(waitId);
+    if (ticketId > 0) {
+        std::cout << "Assigned, ticket ID: " << ticketId << std::endl;
+    } else if (ticketId == 0) {
+        std::cout << "Still waiting. Cancel? (1=Yes, 0=No): ";
+        int cancelChoice;
+        std::cin >> cancelChoice;
+        if (cancelChoice == 1 && waitlist.cancel(waitId)) {
+            std::cout << "Removed from the waitlist" << std::endl;
+        }
+    } else {
+        std::cout << "Unknown, cancelled or expired wait number" << std::endl;
+    }
+}
+
+void ParkingSystemUI::findTicketByPlate() {
+    std::string plate;
+    std::cout << "\nEnter plate (as read): ";
+    std::cin.ignore();
+    std::getline(std::cin, plate);
+    
+    auto matches = plates.search(plate, SystemConfig::FUZZY_MAX_DISTANCE, SystemConfig::FUZZY_MAX_RESULTS);
+    if (matches.empty()) {
+        std::cout << "No parked or recent vehicle matches " << plate << std::endl;
+        return;
+    }
+    for (const auto& match : matches) {
+        std::cout << "Ticket " << match.ticketId << ": " << match.plate
+                  << " in slot " << match.slotId
+                  << (match.active ? " (parked" : " (left")
+                  << (match.distance == 0 ? ", exact)" : ", similar)") << std::endl;
+    }
+}
+
+void ParkingSystemUI::showStayHistory() {
+    if (!stays) {
+        std::cout << "Stay history is not available" << std::endl;
+        return;
+    }
+    std::string plate;
+    int days;
+    std::cout << "\nEnter plate: ";
+    std::cin.ignore();
+    std::getline(std::cin, plate);
+    std::cout << "Days back (0 = " << SystemConfig::STAY_HISTORY_DAYS << "): ";
+    std::cin >> days;
+    if (days <= 0) days = SystemConfig::STAY_HISTORY_DAYS;
+    
+    time_t to = time(0);
+    time_t from = to - static_cast<time_t>(days) * 24 * 3600;
+    std::vector<StayIndex::Stay> visits;
+    try {
+        visits = stays->staysFor(plate, from, to + 1);
+    } catch (const ParkingException& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return;
+    }
+    if (visits.empty()) {
+        std::cout << "No stays for " << plate << " in the last " << days << " days" << std::endl;
+        return;
+    }
+    double total = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& stay : visits) {
+        char entry[32], left[32];
+        std::strftime(entry, sizeof(entry), "%Y-%m-%d %H:%M", std::localtime(&stay.entryTime));
+        std::strftime(left, sizeof(left), "%Y-%m-%d %H:%M", std::localtime(&stay.exitTime));
+        std::cout << entry << " - " << left << "  slot " << stay.slotId
+                  << "  ticket " << stay.ticketId << "  Rp " << stay.amount << std::endl;
+        total += stay.amount;
+    }
+    std::cout << visits.size() << " stays, total Rp " << total << std::endl;
+}
+
 void ParkingSystemUI::run() {
     int choice;
     
@@ -98,9 +370,22 @@ void ParkingSystemUI::run() {
         std::cout << "4. Show current occupation" << std::endl;
         std::cout << "5. Generate daily report" << std::endl;
         std::cout << "6. Save test data" << std::endl;
+        std::cout << "7. Export data (CSV/JSON)" << std::endl;
+        std::cout << "8. Revenue history" << std::endl;
+        std::cout << "9. Peak occupancy" << std::endl;
+        std::cout << "10. Current rates" << std::endl;
+        std::cout << "11. Card payment status" << std::endl;
+        std::cout << "12. Close day (settlement)" << std::endl;
+        std::cout << "13. Reload member list" << std::endl;
+        std::cout << "14. Occupancy forecast" << std::endl;
+        std::cout << "15. Waitlist status" << std::endl;
+        std::cout << "16. Find ticket by plate" << std::endl;
+        std::cout << "17. Stay history by plate" << std::endl;
         std::cout << "0. Exit" << std::endl;
         std::cout << "Choice: ";
         std::cin >> choice;
+        reverseFailedCharges();
+        closeDayIfDue();
         
         switch(choice) {
             case 1:
@@ -121,12 +406,47 @@ void ParkingSystemUI::run() {
             case 6:
                 lot.saveTestData();
                 break;
+            case 7:
+                exportData();
+                break;
+            case 8:
+                showRevenueHistory();
+                break;
+            case 9:
+                showPeakOccupancy();
+                break;
+            case 10:
+                showPriceBoard();
+                break;
+            case 11:
+                checkCardPayment();
+                break;
+            case 12:
+                closeDay();
+                break;
+            case 13:
+                reloadMembers();
+                break;
+            case 14:
+                lot.showForecast();
+                break;
+            case 15:
+                checkWaitlist();
+                break;
+            case 16:
+                findTicketByPlate();
+                break;
+            case 17:
+                showStayHistory();
+                break;
             case 0:
+                payments.drain();
+                reverseFailedCharges();
                 std::cout << "Goodbye!" << std::endl;
                 break;
             default:
                 std::cout << "Invalid choice!" << std::endl;
         }
-        
+    
     } while (choice != 0);
 }
@@ -1,9 +1,20 @@
 #include "ParkingSlot.h"
+#include "ConfigParking.h"
+#include "ParkingClock.h"
+#include <algorithm>
 #include <ctime>
 #include <iostream>
 
 ParkingSlot::ParkingSlot(const std::string& slotId, int lvl) 
-    : id(slotId), level(lvl), occupied(false), vehicle(nullptr) {}
+    : id(slotId), level(lvl), occupied(false), capabilities(VehicleAttribute::NONE), vehicle(nullptr) {
+    if (level == 1 && ParkingLayout::FLOOR_1_MAX_HEIGHT_M > ParkingLayout::FLOOR_2_MAX_HEIGHT_M) {
+        capabilities |= VehicleAttribute::TALL;
+    }
+    const auto& accessible = ParkingLayout::ACCESSIBLE_SLOT_IDS;
+    if (std::find(accessible.begin(), accessible.end(), id) != accessible.end()) {
+        capabilities |= VehicleAttribute::ACCESSIBLE;
+    }
+}
 
 ParkingSlot::~ParkingSlot() {}
 
@@ -11,6 +22,12 @@ std::string ParkingSlot::getId() const { return id; }
 int ParkingSlot::getLevel() const { return level; }
 bool ParkingSlot::isOccupied() const { return occupied; }
 std::shared_ptr<Vehicle> ParkingSlot::getVehicle() const { return vehicle; }
+unsigned ParkingSlot::getCapabilities() const { return capabilities; }
+void ParkingSlot::setCapabilities(unsigned mask) { capabilities = mask; }
+
+bool ParkingSlot::fits(const Vehicle& v) const {
+    return (v.getAttributes() & ~capabilities) == 0;
+}
 
 void ParkingSlot::parkVehicle(std::shared_ptr<Vehicle> v) {
     if (occupied) {
@@ -18,7 +35,7 @@ void ParkingSlot::parkVehicle(std::shared_ptr<Vehicle> v) {
     }
     vehicle = v;
     occupied = true;
-    v->setArrivalTime(time(0));
+    v->setArrivalTime(ParkingClock::now());
 }
 
 void ParkingSlot::unparkVehicle() {
@@ -37,6 +54,10 @@ std::string RegularSlot::getSlotType() const {
     return "Regular";
 }
 
+SlotKind RegularSlot::getKind() const {
+    return SlotKind::REGULAR;
+}
+
 // EVSlot implementation
 EVSlot::EVSlot(const std::string& id, int lvl) : ParkingSlot(id, lvl) {}
 
@@ -48,13 +69,19 @@ std::string EVSlot::getSlotType() const {
     return "EV";
 }
 
+SlotKind EVSlot::getKind() const {
+    return SlotKind::EV;
+}
+
 // VIPSlot implementation
 VIPSlot::VIPSlot(const std::string& id, int lvl) 
-    : ParkingSlot(id, lvl), reserved(false), reservationEnd(0) {}
+    : ParkingSlot(id, lvl), reserved(false), reservationEnd(0) {
+    capabilities |= VehicleAttribute::OVERSIZED;
+}
 
 bool VIPSlot::canPark(const Vehicle& v) const {
     if (reserved) {
-        return v.getPlate() == reservedPlate && time(0) < reservationEnd;
+        return v.getPlate() == reservedPlate && ParkingClock::now() < reservationEnd;
     }
     return true;
 }
@@ -63,6 +90,12 @@ std::string VIPSlot::getSlotType() const {
     return "VIP";
 }
 
+SlotKind VIPSlot::getKind() const {
+    return SlotKind::VIP;
+}
+
+std::string VIPSlot::getReservedPlate() const { return reservedPlate; }
+
 bool VIPSlot::isReserved() const { return reserved; }
 
 void VIPSlot::reserve(const std::string& plate, int durationHours) {
@@ -71,7 +104,7 @@ void VIPSlot::reserve(const std::string& plate, int durationHours) {
     }
     reserved = true;
     reservedPlate = plate;
-    reservationEnd = time(0) + (durationHours * 3600);
+    reservationEnd = ParkingClock::now() + (durationHours * 3600);
 }
 
 void VIPSlot::clearReservation() {
@@ -5,11 +5,14 @@
 #include "Exceptions.h"
 #include <memory>
 
+enum class SlotKind { REGULAR, EV, VIP };
+
 class ParkingSlot {
 protected:
     std::string id;
     int level;
     bool occupied;
+    unsigned capabilities; // VehicleAttribute bits this slot satisfies
     std::shared_ptr<Vehicle> vehicle;
 public:
     ParkingSlot(const std::string& slotId, int lvl);
@@ -19,9 +22,13 @@ public:
     int getLevel() const;
     bool isOccupied() const;
     std::shared_ptr<Vehicle> getVehicle() const;
+    unsigned getCapabilities() const;
+    void setCapabilities(unsigned mask);
+    bool fits(const Vehicle& v) const;
     
     virtual bool canPark(const Vehicle& v) const = 0;
     virtual std::string getSlotType() const = 0;
+    virtual SlotKind getKind() const = 0;
     
     void parkVehicle(std::shared_ptr<Vehicle> v);
     void unparkVehicle();
@@ -32,6 +39,7 @@ public:
     RegularSlot(const std::string& id, int lvl);
     bool canPark(const Vehicle& v) const override;
     std::string getSlotType() const override;
+    SlotKind getKind() const override;
 };
 
 class EVSlot : public ParkingSlot {
@@ -39,6 +47,7 @@ public:
     EVSlot(const std::string& id, int lvl);
     bool canPark(const Vehicle& v) const override;
     std::string getSlotType() const override;
+    SlotKind getKind() const override;
 };
 
 class VIPSlot : public ParkingSlot {
@@ -50,8 +59,10 @@ public:
     VIPSlot(const std::string& id, int lvl);
     bool canPark(const Vehicle& v) const override;
     std::string getSlotType() const override;
+    SlotKind getKind() const override;
     
     bool isReserved() const;
+    std::string getReservedPlate() const;
     void reserve(const std::string& plate, int durationHours);
     void clearReservation();
     double calculateRate(int durationHours) const;
@@ -2,16 +2,55 @@
 #define PARKINGSYSTEMUI_H
 
 #include "ParkingLot.h"
+#include "PaymentHistory.h"
+#include "OccupancyRollup.h"
+#include "PaymentPipeline.h"
+#include "PlateIndex.h"
+#include "StayIndex.h"
+#include "GateSession.h"
+#include "ThreadPool.h"
+#include <mutex>
 
 class ParkingSystemUI {
 private:
     ParkingLot lot;
+    PaymentHistory history;
+    OccupancyRollup rollup;
+    OccupancyForecaster forecaster;
+    PricingEngine pricing;
+    ChargingScheduler charging;
+    std::unique_ptr<AllocationPolicy> allocation;
+    MockPaymentGateway gateway;
+    PaymentPipeline payments;
+    MemberRegistry members;
+    Waitlist waitlist;
+    PlateIndex plates;
+    ThreadPool pool; // reports and settlement
+    std::unique_ptr<StayIndex> stays; // null if the index could not be opened
+    std::string closedDay; // date of the last settlement run
+    ConsoleTerminal console;
+    std::mutex lotMutex;
+    GateDialogContext dialogs; // the gate dialogs, run on the console
     
+    void runDialog(SessionTask dialog);
     void registerAndPark();
     void unparkVehicle();
     void reserveVIP();
-    
+    void exportData();
+    void showRevenueHistory();
+    void showPeakOccupancy();
+    void showPriceBoard();
+    void reverseFailedCharges();
+    void checkCardPayment();
+    void closeDay();
+    void closeDayIfDue();
+    void reloadMembers();
+    void checkWaitlist();
+    void findTicketByPlate();
+    void showStayHistory();
+
 public:
+    ParkingSystemUI();
     void run();
 };
 
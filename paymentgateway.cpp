@@ -0,0 +1,24 @@
+#include "PaymentGateway.h"
+#include <chrono>
+#include <thread>
+
+MockPaymentGateway::MockPaymentGateway(int latency, double transient, double decline, unsigned seed)
+    : latencyMs(latency), transientRate(transient), declineRate(decline), rng(seed) {}
+
+std::vector<PaymentOutcome> MockPaymentGateway::submit(const std::vector<PaymentRequest>& batch) {
+    if (latencyMs > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+    }
+    
+    std::vector<PaymentOutcome> outcomes;
+    outcomes.reserve(batch.size());
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uniform_real_distribution<double> roll(0.0, 1.0);
+    for (size_t i = 0; i < batch.size(); i++) {
+        double r = roll(rng);
+        if (r < declineRate) outcomes.push_back(PaymentOutcome::DECLINED);
+        else if (r < declineRate + transientRate) outcomes.push_back(PaymentOutcome::TRANSIENT_ERROR);
+        else outcomes.push_back(PaymentOutcome::APPROVED);
+    }
+    return outcomes;
+}
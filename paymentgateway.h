@@ -0,0 +1,49 @@
+#ifndef PAYMENTGATEWAY_H
+#define PAYMENTGATEWAY_H
+
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <vector>
+
+enum class PaymentMethod { CASH, CARD };
+
+enum class PaymentOutcome {
+    APPROVED,
+    DECLINED,        // final, do not retry
+    TRANSIENT_ERROR  // timeout or gateway hiccup, safe to retry
+};
+
+struct PaymentRequest {
+    int ticketId;
+    double amount;
+    time_t exitTime;
+    int attempts;
+};
+
+// Card processor. submit() is called from the payment pipeline's worker
+// thread only and may block for the whole network round-trip; it returns one
+// outcome per request, in order.
+class PaymentGateway {
+public:
+    virtual ~PaymentGateway() {}
+    virtual std::vector<PaymentOutcome> submit(const std::vector<PaymentRequest>& batch) = 0;
+};
+
+// In-process stand-in for a card processor: every batch costs one simulated
+// round-trip, and each charge independently fails at the configured rates.
+class MockPaymentGateway : public PaymentGateway {
+private:
+    int latencyMs;
+    double transientRate;
+    double declineRate;
+    std::mutex mutex;
+    std::mt19937 rng;
+    
+public:
+    MockPaymentGateway(int latencyMs, double transientRate, double declineRate, unsigned seed = 12345);
+    
+    std::vector<PaymentOutcome> submit(const std::vector<PaymentRequest>& batch) override;
+};
+
+#endif
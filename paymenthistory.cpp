@@ -0,0 +1,299 @@
+#include "PaymentHistory.h"
+#include "ConfigParking.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// MappedColumn implementation
+MappedColumn::MappedColumn(const std::string& path) : data(nullptr), length(0) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(p);
+            length = st.st_size;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return;
+    fallback.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(fallback.data(), fallback.size());
+    data = fallback.data();
+    length = fallback.size();
+#endif
+}
+
+MappedColumn::~MappedColumn() {
+#ifndef _WIN32
+    if (data) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+#endif
+}
+
+// Summation kernels. Four independent accumulators let the compiler keep
+// them in vector registers instead of serializing on a single sum.
+namespace {
+    double sumAll(const double* amounts, size_t n) {
+        double a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            a0 += amounts[i];
+            a1 += amounts[i + 1];
+            a2 += amounts[i + 2];
+            a3 += amounts[i + 3];
+        }
+        for (; i < n; i++) a0 += amounts[i];
+        return (a0 + a1) + (a2 + a3);
+    }
+    
+    double sumInRange(const int64_t* times, const double* amounts, size_t n, int64_t from, int64_t to) {
+        double a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            a0 += (times[i] >= from && times[i] < to) ? amounts[i] : 0.0;
+            a1 += (times[i + 1] >= from && times[i + 1] < to) ? amounts[i + 1] : 0.0;
+            a2 += (times[i + 2] >= from && times[i + 2] < to) ? amounts[i + 2] : 0.0;
+            a3 += (times[i + 3] >= from && times[i + 3] < to) ? amounts[i + 3] : 0.0;
+        }
+        for (; i < n; i++) {
+            a0 += (times[i] >= from && times[i] < to) ? amounts[i] : 0.0;
+        }
+        return (a0 + a1) + (a2 + a3);
+    }
+    
+    // Sums amounts into buckets[group[i]]; times may be null when the whole
+    // partition lies inside the range.
+    void sumGrouped(const int64_t* times, const double* amounts, const uint8_t* groups, size_t n,
+                    int64_t from, int64_t to, std::vector<double>& buckets) {
+        for (size_t i = 0; i < n; i++) {
+            if (times && (times[i] < from || times[i] >= to)) continue;
+            if (groups[i] >= buckets.size()) buckets.resize(groups[i] + 1, 0.0);
+            buckets[groups[i]] += amounts[i];
+        }
+    }
+    
+    time_t parseDay(const std::string& name, int dayOffset) {
+        std::tm t = {};
+        if (std::sscanf(name.c_str(), "%d-%d-%d", &t.tm_year, &t.tm_mon, &t.tm_mday) != 3) {
+            return -1;
+        }
+        t.tm_year -= 1900;
+        t.tm_mon -= 1;
+        t.tm_mday += dayOffset;
+        t.tm_isdst = -1;
+        return std::mktime(&t);
+    }
+    
+    // Rows committed to a partition: the count file is written after every
+    // column, so rows past it belong to an append a crash interrupted.
+    // Partitions written before the count file existed report SIZE_MAX.
+    size_t committedRows(const std::string& dir) {
+        uint64_t rows;
+        std::ifstream in(dir + "rows.count", std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&rows), sizeof(rows))) return SIZE_MAX;
+        return static_cast<size_t>(rows);
+    }
+    
+    double partitionRevenue(const std::string& dir, bool fullDay, time_t from, time_t to) {
+        MappedColumn amounts(dir + "amount.col");
+        size_t n = std::min(amounts.count<double>(), committedRows(dir));
+        if (fullDay) {
+            return sumAll(amounts.as<double>(), n);
+        }
+        MappedColumn times(dir + "exit_time.col");
+        n = std::min(n, times.count<int64_t>());
+        return sumInRange(times.as<int64_t>(), amounts.as<double>(), n, from, to);
+    }
+    
+    std::vector<double> groupedRevenue(const std::string& root,
+                                       const std::vector<std::pair<time_t, std::string>>& parts,
+                                       time_t from, time_t to, const char* column, size_t groups) {
+        std::vector<double> buckets(groups, 0.0);
+        for (const auto& part : parts) {
+            std::string dir = root + "/" + part.second + "/";
+            bool fullDay = part.first >= from && parseDay(part.second, 1) <= to;
+            MappedColumn amounts(dir + "amount.col");
+            MappedColumn group(dir + column);
+            size_t n = std::min({ amounts.count<double>(), group.count<uint8_t>(), committedRows(dir) });
+            if (fullDay) {
+                sumGrouped(nullptr, amounts.as<double>(), group.as<uint8_t>(), n, from, to, buckets);
+            } else {
+                MappedColumn times(dir + "exit_time.col");
+                n = std::min(n, times.count<int64_t>());
+                sumGrouped(times.as<int64_t>(), amounts.as<double>(), group.as<uint8_t>(), n, from, to, buckets);
+            }
+        }
+        return buckets;
+    }
+}
+
+// PaymentHistory implementation
+PaymentHistory::PaymentHistory(const std::string& rootDir, size_t batchRows)
+    : root(rootDir), openRows(0), committedCount(0), commitRows(batchRows > 0 ? batchRows : 1) {
+    fs::create_directories(root);
+}
+
+PaymentHistory::~PaymentHistory() {
+    commit();
+}
+
+std::string PaymentHistory::dayKey(time_t t) {
+    char buffer[16];
+    std::tm local = *std::localtime(&t);
+    std::strftime(buffer, sizeof(buffer), SystemConfig::DATE_FORMAT.c_str(), &local);
+    return buffer;
+}
+
+void PaymentHistory::openPartition(const std::string& day) {
+    commit();
+    std::string dir = root + "/" + day + "/";
+    openDay.clear();
+    fs::create_directories(dir);
+    std::ofstream* columns[] = { &exitCol, &entryCol, &ticketCol, &amountCol, &vehicleCol, &slotCol, &floorCol };
+    const char* names[] = { "exit_time", "entry_time", "ticket_id", "amount", "vehicle_type", "slot_type", "floor" };
+    const size_t widths[] = { 8, 8, 4, 8, 1, 1, 1 };
+    
+    // Cut every column back to the committed rows so a torn append from a
+    // crash does not shift the rows written after it
+    size_t rows = committedRows(dir);
+    for (int i = 0; i < 7; i++) {
+        std::error_code ec;
+        uintmax_t size = fs::file_size(dir + names[i] + ".col", ec);
+        rows = std::min<size_t>(rows, ec ? 0 : size / widths[i]);
+    }
+    for (int i = 0; i < 7; i++) {
+        std::string path = dir + names[i] + ".col";
+        std::error_code ec;
+        if (fs::exists(path, ec) && fs::file_size(path) > rows * widths[i]) {
+            fs::resize_file(path, rows * widths[i]);
+        }
+        if (columns[i]->is_open()) columns[i]->close();
+        columns[i]->open(path, std::ios::binary | std::ios::app);
+    }
+    if (rowsFile.is_open()) rowsFile.close();
+    rowsFile.open(dir + "rows.count", std::ios::binary | std::ios::trunc);
+    openRows = rows;
+    committedCount = rows;
+    rowsFile.write(reinterpret_cast<const char*>(&openRows), sizeof(openRows)).flush();
+    openDay = day;
+}
+
+void PaymentHistory::append(const Record& record) {
+    std::string day = dayKey(static_cast<time_t>(record.exitTime));
+    if (day != openDay) {
+        openPartition(day);
+    }
+    exitCol.write(reinterpret_cast<const char*>(&record.exitTime), sizeof(record.exitTime));
+    entryCol.write(reinterpret_cast<const char*>(&record.entryTime), sizeof(record.entryTime));
+    ticketCol.write(reinterpret_cast<const char*>(&record.ticketId), sizeof(record.ticketId));
+    amountCol.write(reinterpret_cast<const char*>(&record.amount), sizeof(record.amount));
+    vehicleCol.write(reinterpret_cast<const char*>(&record.vehicleType), 1);
+    slotCol.write(reinterpret_cast<const char*>(&record.slotType), 1);
+    floorCol.write(reinterpret_cast<const char*>(&record.floor), 1);
+    openRows++;
+    if (openRows - committedCount >= commitRows) {
+        commit();
+    }
+}
+
+void PaymentHistory::commit() {
+    if (openDay.empty() || openRows == committedCount) return;
+    std::ofstream* columns[] = { &exitCol, &entryCol, &ticketCol, &amountCol, &vehicleCol, &slotCol, &floorCol };
+    for (std::ofstream* column : columns) {
+        column->flush();
+    }
+    // Committed only once every column holds the rows
+    rowsFile.seekp(0);
+    rowsFile.write(reinterpret_cast<const char*>(&openRows), sizeof(openRows)).flush();
+    committedCount = openRows;
+}
+
+void PaymentHistory::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    Record record;
+    record.exitTime = when;
+    record.entryTime = ticket.getEntryTime();
+    record.ticketId = ticket.getId();
+    record.amount = fee;
+    record.vehicleType = static_cast<uint8_t>(ticket.getVehicle()->getType());
+    record.slotType = static_cast<uint8_t>(slot.getKind());
+    record.floor = static_cast<uint8_t>(slot.getLevel());
+    try {
+        append(record);
+    } catch (const std::exception&) {
+        // Partition directory could not be created; observers must not throw
+    }
+}
+
+void PaymentHistory::onChargeReversed(const Ticket& ticket, const ParkingSlot& slot, time_t when, double amount) {
+    onUnpark(ticket, slot, when, -amount);
+}
+
+size_t PaymentHistory::rowCount(const std::string& day) const {
+    return committedRows(root + "/" + day + "/");
+}
+
+std::string PaymentHistory::columnPath(const std::string& day, const char* column) const {
+    return root + "/" + day + "/" + column + ".col";
+}
+
+std::vector<std::pair<time_t, std::string>> PaymentHistory::partitionsInRange(time_t from, time_t to) const {
+    std::vector<std::pair<time_t, std::string>> result;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        if (!entry.is_directory()) continue;
+        std::string name = entry.path().filename().string();
+        time_t start = parseDay(name, 0);
+        time_t end = parseDay(name, 1);
+        if (start < 0 || end <= from || start >= to) continue;
+        result.push_back({start, name});
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+double PaymentHistory::revenue(time_t from, time_t to) const {
+    double total = 0;
+    for (const auto& part : partitionsInRange(from, to)) {
+        bool fullDay = part.first >= from && parseDay(part.second, 1) <= to;
+        total += partitionRevenue(root + "/" + part.second + "/", fullDay, from, to);
+    }
+    return total;
+}
+
+std::map<std::string, double> PaymentHistory::revenueByDay(time_t from, time_t to) const {
+    std::map<std::string, double> result;
+    for (const auto& part : partitionsInRange(from, to)) {
+        bool fullDay = part.first >= from && parseDay(part.second, 1) <= to;
+        result[part.second] = partitionRevenue(root + "/" + part.second + "/", fullDay, from, to);
+    }
+    return result;
+}
+
+std::vector<double> PaymentHistory::revenueByVehicleType(time_t from, time_t to) const {
+    return groupedRevenue(root, partitionsInRange(from, to), from, to, "vehicle_type.col", 3);
+}
+
+std::vector<double> PaymentHistory::revenueBySlotType(time_t from, time_t to) const {
+    return groupedRevenue(root, partitionsInRange(from, to), from, to, "slot_type.col", 3);
+}
+
+std::vector<double> PaymentHistory::revenueByFloor(time_t from, time_t to) const {
+    return groupedRevenue(root, partitionsInRange(from, to), from, to, "floor.col", 3);
+}
@@ -0,0 +1,98 @@
+#ifndef PAYMENTHISTORY_H
+#define PAYMENTHISTORY_H
+
+#include "ParkingObserver.h"
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Read-only view of one column file. Uses mmap where available and falls
+// back to reading the whole file into memory elsewhere.
+class MappedColumn {
+private:
+    const char* data;
+    size_t length;
+    std::vector<char> fallback;
+
+public:
+    explicit MappedColumn(const std::string& path);
+    ~MappedColumn();
+    MappedColumn(const MappedColumn&) = delete;
+    MappedColumn& operator=(const MappedColumn&) = delete;
+    
+    template <typename T>
+    const T* as() const { return reinterpret_cast<const T*>(data); }
+    
+    template <typename T>
+    size_t count() const { return length / sizeof(T); }
+};
+
+// Persistent history of closed tickets, stored column by column and
+// partitioned into one directory per day:
+//   <root>/YYYY-MM-DD/{exit_time,entry_time,ticket_id,amount,vehicle_type,slot_type,floor}.col
+// plus rows.count. Appends are buffered and committed in batches of
+// commitRows: the columns are flushed, then rows.count is rewritten once, so
+// most exits do no file I/O. A crash loses at most the uncommitted batch;
+// per-row durability would cost eight flushes on every exit.
+// Queries only open the columns they need and read up to rows.count.
+// A failed card charge is recorded as a second row of the ticket with the
+// negative amount; it only adjusts revenue.
+class PaymentHistory : public ParkingObserver {
+public:
+    struct Record {
+        int64_t exitTime;
+        int64_t entryTime;
+        int32_t ticketId;
+        double amount;
+        uint8_t vehicleType;
+        uint8_t slotType;
+        uint8_t floor;
+    };
+
+private:
+    std::string root;
+    std::string openDay;
+    std::ofstream exitCol, entryCol, ticketCol, amountCol, vehicleCol, slotCol, floorCol;
+    std::ofstream rowsFile;  // rows.count: rows committed to the open partition
+    uint64_t openRows;       // written to the open partition, committed or not
+    uint64_t committedCount; // rows covered by rows.count
+    size_t commitRows;
+    
+    void openPartition(const std::string& day);
+
+public:
+    explicit PaymentHistory(const std::string& rootDir, size_t batchRows = 64);
+    ~PaymentHistory();
+    PaymentHistory(const PaymentHistory&) = delete;
+    PaymentHistory& operator=(const PaymentHistory&) = delete;
+    
+    void append(const Record& record);
+    // Flushes buffered rows and commits them to rows.count. Run before
+    // querying in the same process; also done on partition change and
+    // destruction.
+    void commit();
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    void onChargeReversed(const Ticket& ticket, const ParkingSlot& slot, time_t when, double amount) override;
+    
+    // All ranges are [from, to). Grouped results are indexed by the enum
+    // value (VehicleType, SlotKind) or by floor number.
+    double revenue(time_t from, time_t to) const;
+    std::map<std::string, double> revenueByDay(time_t from, time_t to) const;
+    std::vector<double> revenueByVehicleType(time_t from, time_t to) const;
+    std::vector<double> revenueBySlotType(time_t from, time_t to) const;
+    std::vector<double> revenueByFloor(time_t from, time_t to) const;
+    
+    // Day partitions overlapping [from, to) as (day start, day key), sorted
+    std::vector<std::pair<time_t, std::string>> partitionsInRange(time_t from, time_t to) const;
+    std::string columnPath(const std::string& day, const char* column) const;
+    // Rows of a day every column holds; readers clamp column lengths to it
+    size_t rowCount(const std::string& day) const;
+    
+    static std::string dayKey(time_t t);
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "PaymentPipeline.h"
+#include "Exceptions.h"
+#include "ConfigParking.h"
+#include <algorithm>
+
+PaymentPipeline::PaymentPipeline(PaymentGateway& paymentGateway, size_t batch, int flushIntervalMs,
+                                 int attempts, int retryBackoffMs)
+    : gateway(paymentGateway), batchSize(batch > 0 ? batch : 1), flushInterval(flushIntervalMs),
+      maxAttempts(attempts > 0 ? attempts : 1), retryBackoff(retryBackoffMs),
+      inFlight(0), stats{0, 0, 0, 0, 0, 0.0}, stopping(false) {
+    worker = std::thread(&PaymentPipeline::workerLoop, this);
+}
+
+PaymentPipeline::~PaymentPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void PaymentPipeline::setMethod(int ticketId, PaymentMethod method) {
+    std::lock_guard<std::mutex> lock(mutex);
+    methods[ticketId] = method;
+}
+
+void PaymentPipeline::clearMethod(int ticketId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    methods.erase(ticketId);
+}
+
+void PaymentPipeline::setResolved(int ticketId, PaymentStatus status) {
+    statuses[ticketId] = status;
+    resolvedOrder.push_back(ticketId);
+    if (resolvedOrder.size() > PaymentConfig::PAYMENT_STATUS_HISTORY) {
+        statuses.erase(resolvedOrder.front());
+        resolvedOrder.pop_front();
+    }
+}
+
+void PaymentPipeline::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    int ticketId = ticket.getId();
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        PaymentMethod method = PaymentMethod::CASH;
+        auto found = methods.find(ticketId);
+        if (found != methods.end()) {
+            method = found->second;
+            methods.erase(found);
+        }
+        
+        if (method == PaymentMethod::CASH || fee <= 0) {
+            setResolved(ticketId, PaymentStatus::SETTLED);
+            stats.settled++;
+            stats.settledAmount += fee;
+            return;
+        }
+        
+        statuses[ticketId] = PaymentStatus::PENDING;
+        ready.push_back({ticketId, fee, when, 0});
+        stats.queued++;
+        // The first charge starts the worker's flush timer, a full batch ends it
+        notify = ready.size() == 1 || ready.size() >= batchSize;
+    }
+    if (notify) wake.notify_one();
+}
+
+void PaymentPipeline::resolve(const PaymentRequest& request, PaymentOutcome outcome) {
+    if (outcome == PaymentOutcome::TRANSIENT_ERROR && request.attempts < maxAttempts) {
+        // Exponential backoff: 1x, 2x, 4x ...
+        PaymentRequest retry = request;
+        delayed.insert({Clock::now() + retryBackoff * (1 << (request.attempts - 1)), retry});
+        stats.retries++;
+        return;
+    }
+    if (outcome == PaymentOutcome::APPROVED) {
+        setResolved(request.ticketId, PaymentStatus::SETTLED);
+        stats.settled++;
+        stats.settledAmount += request.amount;
+    } else {
+        setResolved(request.ticketId, PaymentStatus::FAILED);
+        unreportedFailures.push_back(request);
+        stats.failed++;
+    }
+}
+
+void PaymentPipeline::workerLoop() {
+    std::vector<PaymentRequest> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Promote retries whose backoff has expired; on shutdown skip the wait
+        Clock::time_point now = Clock::now();
+        while (!delayed.empty() && (stopping || delayed.begin()->first <= now)) {
+            ready.push_back(delayed.begin()->second);
+            delayed.erase(delayed.begin());
+        }
+        
+        if (ready.empty()) {
+            if (stopping && delayed.empty()) return;
+            if (delayed.empty()) wake.wait(lock);
+            else wake.wait_until(lock, delayed.begin()->first);
+            continue;
+        }
+        
+        // Give a partial batch one flush interval to fill up
+        if (ready.size() < batchSize && !stopping) {
+            wake.wait_for(lock, flushInterval, [this] { return stopping || ready.size() >= batchSize; });
+        }
+        
+        size_t take = std::min(batchSize, ready.size());
+        batch.assign(ready.begin(), ready.begin() + take);
+        ready.erase(ready.begin(), ready.begin() + take);
+        for (auto& request : batch) request.attempts++;
+        inFlight += take;
+        stats.batches++;
+        
+        lock.unlock();
+        std::vector<PaymentOutcome> outcomes;
+        try {
+            outcomes = gateway.submit(batch);
+        } catch (...) {
+            outcomes.clear();
+        }
+        // A gateway that throws or answers short counts as a transient error
+        outcomes.resize(batch.size(), PaymentOutcome::TRANSIENT_ERROR);
+        lock.lock();
+        
+        for (size_t i = 0; i < batch.size(); i++) {
+            resolve(batch[i], outcomes[i]);
+        }
+        inFlight -= take;
+        resolved.notify_all();
+    }
+}
+
+PaymentStatus PaymentPipeline::getStatus(int ticketId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = statuses.find(ticketId);
+    return found != statuses.end() ? found->second : PaymentStatus::UNKNOWN;
+}
+
+void PaymentPipeline::confirm(int ticketId) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto found = statuses.find(ticketId);
+    if (found == statuses.end()) {
+        throw InvalidTicketException();
+    }
+    // Looked up again on every wake: resolved statuses age out of the map
+    PaymentStatus status = PaymentStatus::PENDING;
+    resolved.wait(lock, [&] {
+        auto current = statuses.find(ticketId);
+        status = current != statuses.end() ? current->second : PaymentStatus::UNKNOWN;
+        return status != PaymentStatus::PENDING;
+    });
+    if (status == PaymentStatus::FAILED) {
+        throw PaymentException();
+    }
+}
+
+std::vector<PaymentRequest> PaymentPipeline::takeFailures() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<PaymentRequest> failures;
+    failures.swap(unreportedFailures);
+    return failures;
+}
+
+PaymentPipeline::Stats PaymentPipeline::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.notify_one();
+    resolved.wait(lock, [this] { return ready.empty() && delayed.empty() && inFlight == 0; });
+    return stats;
+}
+
+PaymentPipeline::Stats PaymentPipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
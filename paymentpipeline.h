@@ -0,0 +1,92 @@
+#ifndef PAYMENTPIPELINE_H
+#define PAYMENTPIPELINE_H
+
+#include "ParkingObserver.h"
+#include "PaymentGateway.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class PaymentStatus { UNKNOWN, PENDING, SETTLED, FAILED };
+
+// Takes card charges off the exit path. onUnpark only queues the charge, so
+// the slot is released and the gate opens without waiting for the gateway; a
+// worker thread submits queued charges in batches, retries transient errors
+// with a backoff and marks the rest settled or failed. Cash exits settle
+// immediately and never reach the gateway. Failed charges are handed back
+// through takeFailures() so the lot's thread can reverse their revenue; the
+// statuses of the last PAYMENT_STATUS_HISTORY resolved tickets are kept.
+class PaymentPipeline : public ParkingObserver {
+public:
+    struct Stats {
+        size_t queued;
+        size_t settled;
+        size_t failed;
+        size_t retries;
+        size_t batches;
+        double settledAmount;
+    };
+    
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    PaymentGateway& gateway;
+    size_t batchSize;
+    std::chrono::milliseconds flushInterval;
+    int maxAttempts;
+    std::chrono::milliseconds retryBackoff;
+    
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // new work or shutdown
+    std::condition_variable resolved;  // a charge settled or failed
+    std::deque<PaymentRequest> ready;
+    std::multimap<Clock::time_point, PaymentRequest> delayed; // retries waiting out their backoff
+    std::unordered_map<int, PaymentMethod> methods;
+    std::unordered_map<int, PaymentStatus> statuses;
+    std::deque<int> resolvedOrder; // oldest resolved status first
+    std::vector<PaymentRequest> unreportedFailures;
+    size_t inFlight;
+    Stats stats;
+    bool stopping;
+    std::thread worker;
+    
+    void workerLoop();
+    void resolve(const PaymentRequest& request, PaymentOutcome outcome);
+    void setResolved(int ticketId, PaymentStatus status);
+    
+public:
+    PaymentPipeline(PaymentGateway& gateway, size_t batchSize, int flushIntervalMs,
+                    int maxAttempts, int retryBackoffMs);
+    ~PaymentPipeline();
+    PaymentPipeline(const PaymentPipeline&) = delete;
+    PaymentPipeline& operator=(const PaymentPipeline&) = delete;
+    
+    // Chooses how the ticket will be paid; must be called before unpark,
+    // and cleared again if the unpark fails. Tickets without a choice are
+    // paid in cash.
+    void setMethod(int ticketId, PaymentMethod method);
+    void clearMethod(int ticketId);
+    
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    // UNKNOWN for tickets never charged or resolved too long ago
+    PaymentStatus getStatus(int ticketId) const;
+    
+    // Blocks until the ticket's charge is resolved; throws PaymentException
+    // if it was declined or ran out of retries
+    void confirm(int ticketId);
+    
+    // Failed charges not yet returned by a previous call
+    std::vector<PaymentRequest> takeFailures();
+    
+    // Blocks until nothing is queued, delayed or in flight
+    Stats drain();
+    Stats getStats() const;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include "PlateIndex.h"
+#include "MemberRegistry.h"
+#include <algorithm>
+
+namespace {
+    const int MARKER = 36;
+    const size_t MAX_PLATE = MemberTable::MAX_PLATE;
+    const size_t MAX_GRAMS = MAX_PLATE;
+    
+    std::string normalized(const std::string& plate) {
+        char buffer[MAX_PLATE];
+        size_t length = MemberTable::normalize(plate, buffer);
+        return std::string(buffer, length);
+    }
+}
+
+PlateIndex::PlateIndex(time_t recentWindowSeconds)
+    : postings(ALPHABET * ALPHABET * ALPHABET), liveCount(0), recentSeconds(recentWindowSeconds) {}
+
+int PlateIndex::classOf(char c) {
+    // Characters plate readers and people confuse share one class
+    switch (c) {
+        case 'O': case 'D': case 'Q': c = '0'; break;
+        case 'I': case 'L': c = '1'; break;
+        case 'Z': c = '2'; break;
+        case 'S': c = '5'; break;
+        case 'G': c = '6'; break;
+        case 'B': c = '8'; break;
+        default: break;
+    }
+    return c <= '9' ? c - '0' : 10 + (c - 'A');
+}
+
+size_t PlateIndex::trigrams(const std::string& plate, uint16_t* out) {
+    // Start and end markers give short plates and their first and last
+    // characters their own grams
+    size_t count = 0;
+    int first = MARKER;
+    int second = plate.empty() ? MARKER : classOf(plate[0]);
+    for (size_t i = 1; i <= plate.size(); i++) {
+        int third = i < plate.size() ? classOf(plate[i]) : MARKER;
+        out[count++] = static_cast<uint16_t>((first * ALPHABET + second) * ALPHABET + third);
+        first = second;
+        second = third;
+    }
+    std::sort(out, out + count);
+    return std::unique(out, out + count) - out;
+}
+
+int PlateIndex::distance(const std::string& a, const std::string& b, int limit) {
+    const int EDIT = 2;
+    const int LOOKALIKE = 1;
+    int row[MAX_PLATE + 1];
+    int next[MAX_PLATE + 1];
+    size_t m = std::min(b.size(), MAX_PLATE);
+    for (size_t j = 0; j <= m; j++) {
+        row[j] = static_cast<int>(j) * EDIT;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        next[0] = static_cast<int>(i) * EDIT;
+        int best = next[0];
+        for (size_t j = 1; j <= m; j++) {
+            int substitute = a[i - 1] == b[j - 1] ? 0
+                           : classOf(a[i - 1]) == classOf(b[j - 1]) ? LOOKALIKE : EDIT;
+            next[j] = std::min(std::min(row[j] + EDIT, next[j - 1] + EDIT), row[j - 1] + substitute);
+            best = std::min(best, next[j]);
+        }
+        if (best > limit) return limit + 1;
+        std::copy(next, next + m + 1, row);
+    }
+    return std::min(row[m], limit + 1);
+}
+
+void PlateIndex::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    expire(when);
+    std::string plate = normalized(ticket.getVehicle()->getPlate());
+    if (plate.empty()) return;
+    
+    uint32_t index = static_cast<uint32_t>(entries.size());
+    entries.push_back(Entry{ plate, slot.getId(), ticket.getId(), ticket.getEntryTime(), 0, true });
+    hits.push_back(0);
+    uint16_t codes[MAX_GRAMS];
+    size_t count = trigrams(plate, codes);
+    for (size_t i = 0; i < count; i++) {
+        postings[codes[i]].push_back(index);
+    }
+    byTicket[ticket.getId()] = index;
+    liveCount++;
+}
+
+void PlateIndex::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    auto found = byTicket.find(ticket.getId());
+    if (found != byTicket.end()) {
+        entries[found->second].leftAt = when;
+        departed.push_back(found->second);
+        byTicket.erase(found);
+    }
+    expire(when);
+}
+
+void PlateIndex::expire(time_t now) {
+    while (!departed.empty() && entries[departed.front()].leftAt + recentSeconds <= now) {
+        entries[departed.front()].live = false;
+        departed.pop_front();
+        liveCount--;
+    }
+    // Dead entries still sit in the posting lists; rebuild once they are
+    // the majority so the cost is amortized over the removals
+    if (entries.size() > 2 * liveCount + 1024) {
+        compact();
+    }
+}
+
+void PlateIndex::compact() {
+    std::vector<uint32_t> remap(entries.size(), UINT32_MAX);
+    std::vector<Entry> kept;
+    kept.reserve(liveCount);
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!entries[i].live) continue;
+        remap[i] = static_cast<uint32_t>(kept.size());
+        kept.push_back(std::move(entries[i]));
+    }
+    entries.swap(kept);
+    
+    for (auto& list : postings) {
+        size_t out = 0;
+        for (uint32_t index : list) {
+            if (remap[index] != UINT32_MAX) list[out++] = remap[index];
+        }
+        list.resize(out);
+    }
+    for (auto& ticket : byTicket) {
+        ticket.second = remap[ticket.second];
+    }
+    for (auto& index : departed) {
+        index = remap[index];
+    }
+    hits.assign(entries.size(), 0);
+}
+
+std::vector<PlateIndex::Match> PlateIndex::search(const std::string& query, int maxDistance, size_t maxResults) const {
+    std::vector<Match> matches;
+    std::string plate = normalized(query);
+    if (plate.empty()) return matches;
+    
+    // Each ordinary edit removes at most three of the query's trigrams;
+    // look-alike swaps remove none
+    uint16_t codes[MAX_GRAMS];
+    size_t count = trigrams(plate, codes);
+    int required = std::max(1, static_cast<int>(count) - 3 * (maxDistance / 2));
+    
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t index : postings[codes[i]]) {
+            if (hits[index]++ == 0) touched.push_back(index);
+        }
+    }
+    for (uint32_t index : touched) {
+        const Entry& entry = entries[index];
+        if (entry.live && hits[index] >= required) {
+            int d = distance(plate, entry.plate, maxDistance);
+            if (d <= maxDistance) {
+                matches.push_back(Match{ entry.plate, entry.ticketId, entry.slotId, entry.leftAt == 0, d, entry.entryTime });
+            }
+        }
+        hits[index] = 0;
+    }
+    touched.clear();
+    
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        if (a.active != b.active) return a.active;
+        return a.entryTime > b.entryTime;
+    });
+    if (matches.size() > maxResults) matches.resize(maxResults);
+    return matches;
+}
+
+size_t PlateIndex::size() const { return liveCount; }
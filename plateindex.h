@@ -0,0 +1,74 @@
+#ifndef PLATEINDEX_H
+#define PLATEINDEX_H
+
+#include "ParkingObserver.h"
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fuzzy plate search over parked vehicles and those that left within the
+// last FUZZY_RECENT_HOURS, for lost tickets and misread plates. Plates are
+// indexed by the trigrams of their confusion-class form (0/O/D/Q, 1/I/L,
+// 2/Z, 5/S, 6/G, 8/B fold together), so look-alike swaps do not lose
+// overlap; a query counts shared trigrams over the posting lists and ranks
+// the survivors with an edit distance where a look-alike substitution costs
+// half an ordinary edit. Plates under four characters may be missed once
+// an ordinary edit is allowed. Park and unpark update the index in O(plate
+// length); removed entries are skipped until the next compaction.
+// Used from the lot's thread only.
+class PlateIndex : public ParkingObserver {
+public:
+    struct Match {
+        std::string plate;
+        int ticketId;
+        std::string slotId;
+        bool active;       // still parked
+        int distance;      // in half edits: 1 per look-alike swap, 2 per other edit
+        time_t entryTime;
+    };
+    
+private:
+    static const int ALPHABET = 37; // A-Z, 0-9 and the start/end marker
+    
+    struct Entry {
+        std::string plate; // normalized
+        std::string slotId;
+        int ticketId;
+        time_t entryTime;
+        time_t leftAt;     // 0 while parked
+        bool live;         // false once expired; posting references are stale
+    };
+    
+    std::vector<Entry> entries;
+    std::vector<std::vector<uint32_t>> postings;   // trigram code -> entry indices
+    std::unordered_map<int, uint32_t> byTicket;     // parked vehicles
+    std::deque<uint32_t> departed;                  // in leaving order
+    size_t liveCount;
+    time_t recentSeconds;
+    mutable std::vector<uint16_t> hits;             // per-entry shared trigram counts, reset after each query
+    mutable std::vector<uint32_t> touched;
+    
+    static int classOf(char c);
+    static size_t trigrams(const std::string& plate, uint16_t* out);
+    void expire(time_t now);
+    void compact();
+    
+public:
+    explicit PlateIndex(time_t recentWindowSeconds);
+    
+    // Confusion-aware edit distance in half edits, or limit + 1 once it
+    // exceeds limit
+    static int distance(const std::string& a, const std::string& b, int limit);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    // Best matches first: distance, then parked before departed, then newest
+    std::vector<Match> search(const std::string& plate, int maxDistance, size_t maxResults) const;
+    size_t size() const;
+};
+
+#endif
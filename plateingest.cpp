@@ -0,0 +1,194 @@
+#include "PlateIngest.h"
+#include "ConfigParking.h"
+#include "ParkingClock.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+PlateIngestPipeline::PlateIngestPipeline(ParkingLot& parkingLot, int dedupWindowSeconds, size_t batch)
+    : lot(parkingLot), dedupWindow(dedupWindowSeconds), batchSize(batch > 0 ? batch : 1),
+      queue(SystemConfig::PLATE_INGEST_QUEUE_CAPACITY) {}
+
+bool PlateIngestPipeline::parseLine(const char* p, const char* end, PlateEvent& e) {
+    if (end > p && end[-1] == '\r') end--;
+    
+    int64_t ts = 0;
+    const char* start = p;
+    while (p < end && *p >= '0' && *p <= '9') ts = ts * 10 + (*p++ - '0');
+    if (p == start || p == end || *p++ != ',') return false;
+    
+    unsigned gate = 0;
+    start = p;
+    while (p < end && *p >= '0' && *p <= '9') gate = gate * 10 + (*p++ - '0');
+    if (p == start || p == end || *p++ != ',') return false;
+    
+    if (p == end || (*p != 'I' && *p != 'O')) return false;
+    e.entering = (*p++ == 'I');
+    if (p == end || *p++ != ',') return false;
+    
+    start = p;
+    while (p < end && *p != ',') p++;
+    size_t plateLength = p - start;
+    if (plateLength == 0 || plateLength > sizeof(e.plate) || p == end) return false;
+    std::memcpy(e.plate, start, plateLength);
+    e.plateLength = static_cast<uint8_t>(plateLength);
+    p++;
+    
+    if (p + 1 != end) return false;
+    switch (*p) {
+        case 'M': e.type = VehicleType::MOTORCYCLE; break;
+        case 'C': e.type = VehicleType::CAR; break;
+        case 'E': e.type = VehicleType::EV; break;
+        default: return false;
+    }
+    e.timestamp = ts;
+    e.gate = static_cast<uint16_t>(gate);
+    return true;
+}
+
+uint64_t PlateIngestPipeline::plateHash(const PlateEvent& e) {
+    // FNV-1a over the plate, direction folded into the low bit
+    uint64_t h = 1469598103934665603ULL;
+    for (uint8_t i = 0; i < e.plateLength; i++) {
+        h = (h ^ static_cast<unsigned char>(e.plate[i])) * 1099511628211ULL;
+    }
+    return (h & ~1ULL) | (e.entering ? 1 : 0);
+}
+
+void PlateIngestPipeline::produce(std::FILE* input, Stats& stats) {
+    std::vector<char> buffer(1 << 20);
+    size_t carried = 0;
+    while (true) {
+        size_t got = std::fread(buffer.data() + carried, 1, buffer.size() - carried, input);
+        size_t available = carried + got;
+        const char* begin = buffer.data();
+        const char* end = begin + available;
+        const char* line = begin;
+        
+        while (true) {
+            const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            if (!newline) break;
+            if (newline > line) {
+                PlateEvent e;
+                stats.lines++;
+                if (parseLine(line, newline, e)) queue.push(e);
+                else stats.malformed++;
+            }
+            line = newline + 1;
+        }
+        
+        carried = end - line;
+        if (got == 0) {
+            // Last line without a trailing newline
+            if (carried > 0) {
+                PlateEvent e;
+                stats.lines++;
+                if (parseLine(line, end, e)) queue.push(e);
+                else stats.malformed++;
+            }
+            break;
+        }
+        if (carried == buffer.size()) {
+            // Absurdly long line: drop it rather than grow without bound
+            stats.malformed++;
+            carried = 0;
+        } else {
+            std::memmove(buffer.data(), line, carried);
+        }
+    }
+    queue.close();
+}
+
+bool PlateIngestPipeline::isDuplicate(const PlateEvent& e) {
+    while (!expiry.empty() && expiry.front().first + dedupWindow < e.timestamp) {
+        auto it = lastSeen.find(expiry.front().second);
+        if (it != lastSeen.end() && it->second == expiry.front().first) {
+            lastSeen.erase(it);
+        }
+        expiry.pop_front();
+    }
+    uint64_t key = plateHash(e);
+    auto it = lastSeen.find(key);
+    if (it != lastSeen.end() && e.timestamp - it->second <= dedupWindow) {
+        return true;
+    }
+    lastSeen[key] = e.timestamp;
+    expiry.push_back({e.timestamp, key});
+    return false;
+}
+
+void PlateIngestPipeline::dispatch(const PlateEvent& e, Stats& stats) {
+    // The lot sees the camera's time: a replayed stay is billed for its
+    // recorded length and entry is checked against the hours at that time
+    VirtualClock clock(static_cast<time_t>(e.timestamp));
+    uint64_t vehicleKey = plateHash(e) & ~1ULL;
+    try {
+        if (e.entering) {
+            if (activeTickets.count(vehicleKey)) {
+                stats.rejected++; // already inside
+                return;
+            }
+            std::string plate(e.plate, e.plateLength);
+            std::shared_ptr<Vehicle> vehicle;
+            switch (e.type) {
+                case VehicleType::MOTORCYCLE: vehicle = std::make_shared<Motorcycle>(plate, "ANPR"); break;
+                case VehicleType::CAR: vehicle = std::make_shared<Car>(plate, "ANPR"); break;
+                case VehicleType::EV: vehicle = std::make_shared<EV>(plate, "ANPR", false); break;
+            }
+            activeTickets[vehicleKey] = lot.parkVehicle(vehicle)->getId();
+            stats.parked++;
+        } else {
+            auto it = activeTickets.find(vehicleKey);
+            if (it == activeTickets.end()) {
+                stats.rejected++;
+                return;
+            }
+            int ticketId = it->second;
+            activeTickets.erase(it);
+            lot.unparkVehicle(ticketId);
+            stats.unparked++;
+        }
+    } catch (const ParkingException&) {
+        stats.rejected++;
+    }
+}
+
+void PlateIngestPipeline::consume(Stats& stats) {
+    std::vector<PlateEvent> batch;
+    batch.reserve(batchSize);
+    while (true) {
+        PlateEvent e;
+        while (batch.size() < batchSize && queue.tryPop(e)) {
+            batch.push_back(e);
+        }
+        if (batch.empty()) {
+            if (queue.finished()) return;
+            std::this_thread::yield();
+            continue;
+        }
+        for (const PlateEvent& event : batch) {
+            if (isDuplicate(event)) stats.duplicates++;
+            else dispatch(event, stats);
+        }
+        batch.clear();
+    }
+}
+
+PlateIngestPipeline::Stats PlateIngestPipeline::run(std::FILE* input) {
+    Stats stats = {0, 0, 0, 0, 0, 0};
+    std::thread producer([this, input, &stats] { produce(input, stats); });
+    consume(stats);
+    producer.join();
+    return stats;
+}
+
+PlateIngestPipeline::Stats PlateIngestPipeline::runFile(const std::string& path) {
+    if (path == "-") return run(stdin);
+    std::FILE* input = std::fopen(path.c_str(), "rb");
+    if (!input) {
+        throw ParkingException("Cannot open plate event file: " + path);
+    }
+    Stats stats = run(input);
+    std::fclose(input);
+    return stats;
+}
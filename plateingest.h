@@ -0,0 +1,69 @@
+#ifndef PLATEINGEST_H
+#define PLATEINGEST_H
+
+#include "ParkingLot.h"
+#include "SpscQueue.h"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+// One plate read from an entry/exit camera. The plate is stored inline so
+// events can cross the queue without heap allocation.
+struct PlateEvent {
+    int64_t timestamp;
+    uint16_t gate;
+    bool entering;
+    VehicleType type;
+    uint8_t plateLength;
+    char plate[16];
+};
+
+// Ingests camera plate reads, one per line:
+//   <epoch seconds>,<gate>,<I|O>,<plate>,<M|C|E>
+// A parser thread scans large read buffers in place and pushes fixed-size
+// events into a lock-free SPSC queue. The dispatcher thread drains it in
+// batches, drops repeated reads of the same plate within the dedup window
+// and turns the rest into park/unpark calls on the lot, made at the event's
+// timestamp through a VirtualClock.
+class PlateIngestPipeline {
+public:
+    struct Stats {
+        uint64_t lines;
+        uint64_t malformed;
+        uint64_t duplicates;
+        uint64_t parked;
+        uint64_t unparked;
+        uint64_t rejected;  // no slot, unknown plate on exit, ...
+    };
+    
+private:
+    ParkingLot& lot;
+    int64_t dedupWindow;
+    size_t batchSize;
+    SpscQueue<PlateEvent> queue;
+    
+    // Last accepted read per (plate, direction), expired in time order
+    std::unordered_map<uint64_t, int64_t> lastSeen;
+    std::deque<std::pair<int64_t, uint64_t>> expiry;
+    // Tickets issued by this pipeline, keyed by plate hash
+    std::unordered_map<uint64_t, int> activeTickets;
+    
+    static uint64_t plateHash(const PlateEvent& e);
+    void produce(std::FILE* input, Stats& stats);
+    void consume(Stats& stats);
+    bool isDuplicate(const PlateEvent& e);
+    void dispatch(const PlateEvent& e, Stats& stats);
+    
+public:
+    PlateIngestPipeline(ParkingLot& parkingLot, int dedupWindowSeconds, size_t batch);
+    
+    // Parses one line (without newline); false if malformed
+    static bool parseLine(const char* begin, const char* end, PlateEvent& e);
+    
+    Stats run(std::FILE* input);
+    Stats runFile(const std::string& path); // "-" reads stdin
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "PricingEngine.h"
+#include "ConfigParking.h"
+#include <cmath>
+
+double PricingEngine::baseRate(VehicleType vehicle, SlotKind kind) {
+    if (kind == SlotKind::VIP) {
+        // VIP is priced from the car rate regardless of vehicle
+        return ParkingRate::CAR_RATE_PER_HOUR * (1.0 + ParkingRate::VIP_SURCHARGE_PERCENTAGE / 100.0);
+    }
+    switch(vehicle) {
+        case VehicleType::MOTORCYCLE: return ParkingRate::MOTORCYCLE_RATE_PER_HOUR;
+        case VehicleType::CAR: return ParkingRate::CAR_RATE_PER_HOUR;
+        case VehicleType::EV: return ParkingRate::EV_RATE_PER_HOUR;
+        default: return ParkingRate::CAR_RATE_PER_HOUR;
+    }
+}
+
+double PricingEngine::multiplier(int occupied, int capacity) {
+    if (capacity <= 0) return 1.0;
+    double utilization = occupied * 100.0 / capacity;
+    double threshold = ParkingRate::DYNAMIC_PRICING_THRESHOLD_PERCENTAGE;
+    if (utilization <= threshold) return 1.0;
+    double ratio = (utilization - threshold) / (100.0 - threshold);
+    return 1.0 + ratio * (ParkingRate::DYNAMIC_PRICING_MAX_MULTIPLIER - 1.0);
+}
+
+PricingEngine::Cell* PricingEngine::cellFor(int floor, SlotKind kind) {
+    size_t index = static_cast<size_t>(floor) * KINDS + static_cast<int>(kind);
+    return floor >= 0 && index < cells.size() ? &cells[index] : nullptr;
+}
+
+const PricingEngine::Cell* PricingEngine::cellFor(int floor, SlotKind kind) const {
+    size_t index = static_cast<size_t>(floor) * KINDS + static_cast<int>(kind);
+    return floor >= 0 && index < cells.size() ? &cells[index] : nullptr;
+}
+
+void PricingEngine::reprice(Cell& cell, SlotKind kind) {
+    double factor = multiplier(cell.occupied, cell.capacity);
+    for (int v = 0; v < VEHICLE_TYPES; v++) {
+        // Rounded to whole Rupiah (tarifdetail.txt V.2)
+        cell.rates[v] = std::round(baseRate(static_cast<VehicleType>(v), kind) * factor);
+    }
+}
+
+void PricingEngine::registerSlot(const ParkingSlot& slot) {
+    size_t index = static_cast<size_t>(slot.getLevel()) * KINDS + static_cast<int>(slot.getKind());
+    if (index >= cells.size()) {
+        cells.resize(index + 1, Cell{0, 0, {0, 0, 0}});
+    }
+    Cell& cell = cells[index];
+    cell.capacity++;
+    if (slot.isOccupied()) cell.occupied++;
+    reprice(cell, slot.getKind());
+}
+
+void PricingEngine::onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) {
+    Cell* cell = cellFor(slot.getLevel(), slot.getKind());
+    if (!cell) return;
+    cell->occupied++;
+    reprice(*cell, slot.getKind());
+}
+
+void PricingEngine::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    Cell* cell = cellFor(slot.getLevel(), slot.getKind());
+    if (!cell || cell->occupied == 0) return;
+    cell->occupied--;
+    reprice(*cell, slot.getKind());
+}
+
+double PricingEngine::quote(int floor, SlotKind kind, VehicleType vehicle) const {
+    const Cell* cell = cellFor(floor, kind);
+    if (!cell || cell->capacity == 0) return baseRate(vehicle, kind);
+    return cell->rates[static_cast<int>(vehicle)];
+}
+
+double PricingEngine::utilization(int floor, SlotKind kind) const {
+    const Cell* cell = cellFor(floor, kind);
+    if (!cell || cell->capacity == 0) return 0.0;
+    return cell->occupied * 100.0 / cell->capacity;
+}
@@ -0,0 +1,39 @@
+#ifndef PRICINGENGINE_H
+#define PRICINGENGINE_H
+
+#include "ParkingObserver.h"
+#include <vector>
+
+// Occupancy-driven hourly rates per floor and slot kind. Occupied/capacity
+// counters are updated on park and unpark, and only the quotes for the
+// affected floor and kind are recomputed, so quote() is a table lookup.
+class PricingEngine : public ParkingObserver {
+private:
+    static const int KINDS = 3;
+    static const int VEHICLE_TYPES = 3;
+    
+    struct Cell {
+        int capacity;
+        int occupied;
+        double rates[VEHICLE_TYPES]; // current hourly rate per VehicleType
+    };
+    std::vector<Cell> cells; // indexed by floor * KINDS + kind
+    
+    Cell* cellFor(int floor, SlotKind kind);
+    const Cell* cellFor(int floor, SlotKind kind) const;
+    void reprice(Cell& cell, SlotKind kind);
+    
+public:
+    static double baseRate(VehicleType vehicle, SlotKind kind);
+    static double multiplier(int occupied, int capacity);
+    
+    void registerSlot(const ParkingSlot& slot);
+    
+    void onPark(const Ticket& ticket, const ParkingSlot& slot, time_t when) override;
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    double quote(int floor, SlotKind kind, VehicleType vehicle) const;
+    double utilization(int floor, SlotKind kind) const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "ReportEngine.h"
+#include <algorithm>
+#include <memory>
+
+// ReportSummary implementation
+ReportSummary::ReportSummary()
+    : vehicleCounts{0, 0, 0}, closedTickets(0), revenue(0), totalStaySeconds(0) {}
+
+void ReportSummary::merge(const ReportSummary& other) {
+    for (int i = 0; i < 3; i++) {
+        vehicleCounts[i] += other.vehicleCounts[i];
+    }
+    closedTickets += other.closedTickets;
+    revenue += other.revenue;
+    totalStaySeconds += other.totalStaySeconds;
+    if (occupiedSecondsPerFloor.size() < other.occupiedSecondsPerFloor.size()) {
+        occupiedSecondsPerFloor.resize(other.occupiedSecondsPerFloor.size(), 0.0);
+    }
+    for (size_t i = 0; i < other.occupiedSecondsPerFloor.size(); i++) {
+        occupiedSecondsPerFloor[i] += other.occupiedSecondsPerFloor[i];
+    }
+}
+
+double ReportSummary::averageStayHours() const {
+    return closedTickets > 0 ? totalStaySeconds / closedTickets / 3600.0 : 0.0;
+}
+
+// ReportEngine implementation
+ReportEngine::ReportEngine(ThreadPool& threadPool, size_t chunk)
+    : pool(threadPool), chunkSize(chunk) {}
+
+ReportSummary ReportEngine::summarize(const PaymentHistory& history, time_t from, time_t to) const {
+    struct Partition {
+        std::unique_ptr<MappedColumn> exitTimes, entryTimes, amounts, vehicleTypes, floors;
+        size_t count;
+    };
+    struct Chunk {
+        const Partition* partition;
+        size_t begin, end;
+    };
+    
+    std::vector<Partition> partitions;
+    std::vector<Chunk> chunks;
+    for (const auto& day : history.partitionsInRange(from, to)) {
+        Partition part;
+        part.exitTimes.reset(new MappedColumn(history.columnPath(day.second, "exit_time")));
+        part.entryTimes.reset(new MappedColumn(history.columnPath(day.second, "entry_time")));
+        part.amounts.reset(new MappedColumn(history.columnPath(day.second, "amount")));
+        part.vehicleTypes.reset(new MappedColumn(history.columnPath(day.second, "vehicle_type")));
+        part.floors.reset(new MappedColumn(history.columnPath(day.second, "floor")));
+        part.count = std::min({ part.exitTimes->count<int64_t>(), part.entryTimes->count<int64_t>(),
+                                part.amounts->count<double>(), part.vehicleTypes->count<uint8_t>(),
+                                part.floors->count<uint8_t>(), history.rowCount(day.second) });
+        partitions.push_back(std::move(part));
+    }
+    // Chunks are built after all partitions are in place so the pointers stay valid
+    for (const auto& part : partitions) {
+        for (size_t begin = 0; begin < part.count; begin += chunkSize) {
+            chunks.push_back({ &part, begin, std::min(begin + chunkSize, part.count) });
+        }
+    }
+    
+    std::vector<ReportSummary> partials(chunks.size());
+    pool.parallelFor(chunks.size(), 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; c++) {
+            const Chunk& chunk = chunks[c];
+            const int64_t* exits = chunk.partition->exitTimes->as<int64_t>();
+            const int64_t* entries = chunk.partition->entryTimes->as<int64_t>();
+            const double* amounts = chunk.partition->amounts->as<double>();
+            const uint8_t* types = chunk.partition->vehicleTypes->as<uint8_t>();
+            const uint8_t* floors = chunk.partition->floors->as<uint8_t>();
+            
+            ReportSummary& partial = partials[c];
+            for (size_t i = chunk.begin; i < chunk.end; i++) {
+                if (exits[i] < from || exits[i] >= to) continue;
+                if (amounts[i] < 0) {
+                    partial.revenue += amounts[i]; // reversed charge, not a stay
+                    continue;
+                }
+                if (types[i] < 3) partial.vehicleCounts[types[i]]++;
+                partial.closedTickets++;
+                partial.revenue += amounts[i];
+                partial.totalStaySeconds += static_cast<double>(exits[i] - entries[i]);
+                
+                int64_t overlap = exits[i] - std::max<int64_t>(entries[i], from);
+                if (floors[i] >= partial.occupiedSecondsPerFloor.size()) {
+                    partial.occupiedSecondsPerFloor.resize(floors[i] + 1, 0.0);
+                }
+                partial.occupiedSecondsPerFloor[floors[i]] += static_cast<double>(overlap);
+            }
+        }
+    });
+    
+    ReportSummary total;
+    for (const auto& partial : partials) total.merge(partial);
+    return total;
+}
+
+double ReportEngine::utilization(const ReportSummary& summary, int floor, int floorCapacity,
+                                 time_t from, time_t to) {
+    if (floor < 0 || static_cast<size_t>(floor) >= summary.occupiedSecondsPerFloor.size()
+        || floorCapacity <= 0 || to <= from) {
+        return 0.0;
+    }
+    return summary.occupiedSecondsPerFloor[floor] * 100.0 / (static_cast<double>(floorCapacity) * (to - from));
+}
@@ -0,0 +1,41 @@
+#ifndef REPORTENGINE_H
+#define REPORTENGINE_H
+
+#include "PaymentHistory.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// Aggregate produced by ReportEngine. Per-thread partials are merged with
+// merge(), so every field must be a plain sum.
+struct ReportSummary {
+    long long vehicleCounts[3];      // indexed by VehicleType
+    long long closedTickets;
+    double revenue;
+    double totalStaySeconds;
+    std::vector<double> occupiedSecondsPerFloor; // indexed by floor number
+    
+    ReportSummary();
+    void merge(const ReportSummary& other);
+    double averageStayHours() const;
+};
+
+// Splits the payment history into chunks and aggregates them on a
+// ThreadPool. Each chunk fills its own ReportSummary; the partials are
+// merged once at the end, so workers never share counters.
+class ReportEngine {
+private:
+    ThreadPool& pool;
+    size_t chunkSize;
+    
+public:
+    ReportEngine(ThreadPool& threadPool, size_t chunk = 1 << 16);
+    
+    // Closed-ticket history in [from, to). Stay time is clipped to the range
+    // so occupiedSecondsPerFloor can be turned into utilization.
+    ReportSummary summarize(const PaymentHistory& history, time_t from, time_t to) const;
+    
+    static double utilization(const ReportSummary& summary, int floor, int floorCapacity,
+                              time_t from, time_t to);
+};
+
+#endif
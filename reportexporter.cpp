@@ -0,0 +1,153 @@
+#include "ReportExporter.h"
+#include "ConfigParking.h"
+#include <cstdio>
+
+ReportExporter::ReportExporter(std::ostream& os, ExportFormat fmt)
+    : out(os), format(fmt), firstField(true) {}
+
+void ReportExporter::beginRecord() {
+    firstField = true;
+    if (format == ExportFormat::JSON_LINES) {
+        out.put('{');
+    }
+}
+
+void ReportExporter::endRecord() {
+    if (format == ExportFormat::JSON_LINES) {
+        out.put('}');
+    }
+    out.put('\n'); // no std::endl, the stream decides when to flush
+}
+
+void ReportExporter::writeKey(const char* key) {
+    if (!firstField) {
+        out.put(',');
+    }
+    firstField = false;
+    if (format == ExportFormat::JSON_LINES) {
+        out.put('"');
+        out << key;
+        out.write("\":", 2);
+    }
+}
+
+void ReportExporter::writeString(const char* key, const std::string& value) {
+    writeKey(key);
+    out.put('"');
+    for (char c : value) {
+        if (c == '"') {
+            // CSV doubles the quote, JSON escapes it
+            out.put(format == ExportFormat::CSV ? '"' : '\\');
+        } else if (c == '\\' && format == ExportFormat::JSON_LINES) {
+            out.put('\\');
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            // JSON forbids raw control characters; CSV keeps each record on one line
+            if (format == ExportFormat::JSON_LINES) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out.write(escaped, 6);
+                continue;
+            }
+            if (c == '\n' || c == '\r') c = ' ';
+        }
+        out.put(c);
+    }
+    out.put('"');
+}
+
+void ReportExporter::writeInt(const char* key, long long value) {
+    char buffer[24];
+    int len = std::snprintf(buffer, sizeof(buffer), "%lld", value);
+    writeKey(key);
+    out.write(buffer, len);
+}
+
+void ReportExporter::writeAmount(const char* key, double value) {
+    char buffer[32];
+    int len = std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+    writeKey(key);
+    out.write(buffer, len);
+}
+
+void ReportExporter::writeTime(const char* key, time_t value) {
+    char buffer[32];
+    size_t len = 0;
+    if (value != 0) {
+        std::tm local = *std::localtime(&value);
+        len = std::strftime(buffer, sizeof(buffer), SystemConfig::TIME_FORMAT.c_str(), &local);
+    }
+    writeKey(key);
+    if (len == 0) {
+        if (format == ExportFormat::JSON_LINES) {
+            out.write("null", 4);
+        }
+        return;
+    }
+    out.put('"');
+    out.write(buffer, len);
+    out.put('"');
+}
+
+void ReportExporter::writeBool(const char* key, bool value) {
+    writeKey(key);
+    if (format == ExportFormat::JSON_LINES) {
+        out << (value ? "true" : "false");
+    } else {
+        out.put(value ? '1' : '0');
+    }
+}
+
+void ReportExporter::writeTicketHeader() {
+    if (format == ExportFormat::CSV) {
+        out << "ticket_id,plate,owner,vehicle_type,slot_id,entry_time,paid\n";
+    }
+}
+
+void ReportExporter::writePaymentHeader() {
+    if (format == ExportFormat::CSV) {
+        out << "timestamp,amount\n";
+    }
+}
+
+void ReportExporter::writeSlotHeader() {
+    if (format == ExportFormat::CSV) {
+        out << "slot_id,slot_type,level,occupied,plate,vehicle_type\n";
+    }
+}
+
+void ReportExporter::writeTicket(const Ticket& ticket) {
+    const Vehicle& vehicle = *ticket.getVehicle();
+    beginRecord();
+    writeInt("ticket_id", ticket.getId());
+    writeString("plate", vehicle.getPlate());
+    writeString("owner", vehicle.getOwner());
+    writeString("vehicle_type", vehicle.getTypeName());
+    writeString("slot_id", ticket.getSlotId());
+    writeTime("entry_time", ticket.getEntryTime());
+    writeBool("paid", ticket.isPaid());
+    endRecord();
+}
+
+void ReportExporter::writePayment(time_t timestamp, double amount) {
+    beginRecord();
+    writeTime("timestamp", timestamp);
+    writeAmount("amount", amount);
+    endRecord();
+}
+
+void ReportExporter::writeSlot(const ParkingSlot& slot) {
+    beginRecord();
+    writeString("slot_id", slot.getId());
+    writeString("slot_type", slot.getSlotType());
+    writeInt("level", slot.getLevel());
+    writeBool("occupied", slot.isOccupied());
+    if (slot.isOccupied()) {
+        const Vehicle& vehicle = *slot.getVehicle();
+        writeString("plate", vehicle.getPlate());
+        writeString("vehicle_type", vehicle.getTypeName());
+    } else {
+        writeString("plate", "");
+        writeString("vehicle_type", "");
+    }
+    endRecord();
+}
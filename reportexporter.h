@@ -0,0 +1,41 @@
+#ifndef REPORTEXPORTER_H
+#define REPORTEXPORTER_H
+
+#include "ParkingSlot.h"
+#include "Ticket.h"
+#include <ostream>
+#include <ctime>
+
+enum class ExportFormat { CSV, JSON_LINES };
+
+// Streams tickets, payments and slot occupancy as CSV or JSON lines.
+// Every field is formatted into a small fixed buffer and written straight to
+// the output stream, so memory use does not grow with the history size.
+class ReportExporter {
+private:
+    std::ostream& out;
+    ExportFormat format;
+    bool firstField;
+
+    void beginRecord();
+    void endRecord();
+    void writeKey(const char* key);
+    void writeString(const char* key, const std::string& value);
+    void writeInt(const char* key, long long value);
+    void writeAmount(const char* key, double value);
+    void writeTime(const char* key, time_t value);
+    void writeBool(const char* key, bool value);
+
+public:
+    ReportExporter(std::ostream& os, ExportFormat fmt);
+
+    void writeTicketHeader();
+    void writePaymentHeader();
+    void writeSlotHeader();
+
+    void writeTicket(const Ticket& ticket);
+    void writePayment(time_t timestamp, double amount);
+    void writeSlot(const ParkingSlot& slot);
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "Settlement.h"
+#include "ConfigParking.h"
+#include "Exceptions.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// SettlementSnapshot implementation
+void SettlementSnapshot::addOpenTicket(int ticketId, time_t entryTime, double hourlyRate,
+                                       double flatFee, double energyFee, uint8_t vehicleType) {
+    ticketIds.push_back(ticketId);
+    entryTimes.push_back(entryTime);
+    hourlyRates.push_back(hourlyRate);
+    flatFees.push_back(flatFee);
+    energyFees.push_back(energyFee);
+    vehicleTypes.push_back(vehicleType);
+}
+
+// SettlementJob implementation
+SettlementJob::SettlementJob(ThreadPool& threadPool, const std::string& closeDir, size_t chunk)
+    : pool(threadPool), directory(closeDir), chunkSize(chunk > 0 ? chunk : 1) {}
+
+void SettlementJob::priceRange(const int64_t* entry, const double* rate, const double* flat,
+                               const double* energy, double* fee, size_t count, int64_t closeTime) {
+    const double discount = 1.0 - ParkingRate::LONG_TERM_DISCOUNT_PERCENTAGE / 100.0;
+    const double threshold = ParkingRate::LONG_TERM_DISCOUNT_HOURS;
+    for (size_t i = 0; i < count; i++) {
+        // Same rounding as Ticket::calculateFee: whole hours, at least one
+        double hours = static_cast<double>((closeTime - entry[i]) / 3600);
+        hours = hours < 1.0 ? 1.0 : hours;
+        double gross = hours * rate[i] + flat[i];
+        fee[i] = gross * (hours > threshold ? discount : 1.0) + energy[i];
+    }
+}
+
+DailyClose SettlementJob::price(const SettlementSnapshot& snapshot) const {
+    struct Partial {
+        double byType[3];
+    };
+    
+    size_t count = snapshot.openTickets();
+    std::vector<double> fees(count);
+    std::vector<Partial> partials((count + chunkSize - 1) / chunkSize);
+    pool.parallelFor(count, chunkSize, [&](size_t begin, size_t end) {
+        priceRange(snapshot.entryTimes.data() + begin, snapshot.hourlyRates.data() + begin,
+                   snapshot.flatFees.data() + begin, snapshot.energyFees.data() + begin,
+                   fees.data() + begin, end - begin, snapshot.closeTime);
+        Partial& partial = partials[begin / chunkSize];
+        partial.byType[0] = partial.byType[1] = partial.byType[2] = 0;
+        for (size_t i = begin; i < end; i++) {
+            partial.byType[snapshot.vehicleTypes[i] % 3] += fees[i];
+        }
+    });
+    
+    DailyClose record;
+    record.epoch = snapshot.epoch;
+    record.closeTime = snapshot.closeTime;
+    record.closedTickets = snapshot.closedTickets;
+    record.revenue = snapshot.revenue;
+    record.openTickets = count;
+    record.accrued = 0;
+    record.accruedByType[0] = record.accruedByType[1] = record.accruedByType[2] = 0;
+    for (const Partial& partial : partials) {
+        for (int t = 0; t < 3; t++) {
+            record.accruedByType[t] += partial.byType[t];
+        }
+    }
+    for (int t = 0; t < 3; t++) {
+        record.accrued += record.accruedByType[t];
+    }
+    return record;
+}
+
+std::string SettlementJob::writeCloseRecord(const DailyClose& record) const {
+    fs::create_directories(directory);
+    
+    char day[16];
+    std::tm local = *std::localtime(&record.closeTime);
+    std::strftime(day, sizeof(day), SystemConfig::DATE_FORMAT.c_str(), &local);
+    std::string path = directory + "/" + day + ".json";
+    std::string temp = path + ".tmp";
+    
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out) {
+            throw ParkingException("Cannot write close record: " + temp);
+        }
+        out << std::fixed << std::setprecision(2)
+            << "{\n"
+            << "  \"epoch\": " << record.epoch << ",\n"
+            << "  \"close_time\": " << static_cast<long long>(record.closeTime) << ",\n"
+            << "  \"closed_tickets\": " << record.closedTickets << ",\n"
+            << "  \"revenue\": " << record.revenue << ",\n"
+            << "  \"open_tickets\": " << record.openTickets << ",\n"
+            << "  \"accrued\": " << record.accrued << ",\n"
+            << "  \"accrued_by_type\": { \"motorcycle\": " << record.accruedByType[0]
+            << ", \"car\": " << record.accruedByType[1]
+            << ", \"ev\": " << record.accruedByType[2] << " }\n"
+            << "}\n";
+        out.flush();
+        if (!out) {
+            throw ParkingException("Cannot write close record: " + temp);
+        }
+    }
+    
+    // Make the contents durable before the rename publishes them
+    FILE* handle = std::fopen(temp.c_str(), "rb");
+    if (handle) {
+        fsync(fileno(handle));
+        std::fclose(handle);
+    }
+    fs::rename(temp, path);
+    return path;
+}
+
+DailyClose SettlementJob::settle(const SettlementSnapshot& snapshot) const {
+    DailyClose record = price(snapshot);
+    writeCloseRecord(record);
+    return record;
+}
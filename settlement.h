@@ -0,0 +1,72 @@
+#ifndef SETTLEMENT_H
+#define SETTLEMENT_H
+
+#include "ThreadPool.h"
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Open tickets and closed-ticket totals of one epoch, copied out of the lot
+// at closing time. Open tickets are stored column by column with the tariff
+// already reduced to (hourly rate, flat fee) plus the energy charged so far,
+// so pricing needs no virtual calls and no access to the live lot.
+struct SettlementSnapshot {
+    int epoch;
+    time_t closeTime;
+    long long closedTickets;
+    double revenue;
+    
+    std::vector<int32_t> ticketIds;
+    std::vector<int64_t> entryTimes;
+    std::vector<double> hourlyRates;
+    std::vector<double> flatFees;
+    std::vector<double> energyFees; // not discounted, as at the exit
+    std::vector<uint8_t> vehicleTypes;
+    
+    size_t openTickets() const { return ticketIds.size(); }
+    void addOpenTicket(int ticketId, time_t entryTime, double hourlyRate, double flatFee, double energyFee,
+                       uint8_t vehicleType);
+};
+
+// The day's close record
+struct DailyClose {
+    int epoch;
+    time_t closeTime;
+    long long closedTickets;
+    double revenue;
+    long long openTickets;
+    double accrued;             // overnight accrual of still-open tickets
+    double accruedByType[3];    // indexed by VehicleType
+};
+
+// End-of-day settlement. The lot only has to produce the snapshot (a copy
+// of its open tickets) and can keep serving gates in the next epoch while
+// settle() prices the snapshot in parallel chunks and writes the close
+// record.
+class SettlementJob {
+private:
+    ThreadPool& pool;
+    std::string directory;
+    size_t chunkSize;
+
+public:
+    SettlementJob(ThreadPool& threadPool, const std::string& closeDir, size_t chunk = 1 << 14);
+    
+    // fee[i] for tickets entered at entry[i], priced up to closeTime. The
+    // long-term discount applies to the parking part only, energy[i] is
+    // added after it. Branch-free over plain arrays so the compiler can
+    // vectorize it.
+    static void priceRange(const int64_t* entry, const double* rate, const double* flat,
+                           const double* energy, double* fee, size_t count, int64_t closeTime);
+    
+    DailyClose price(const SettlementSnapshot& snapshot) const;
+    
+    // Writes <dir>/<date>.json through a temporary file and a rename, so a
+    // crash never leaves a half-written record
+    std::string writeCloseRecord(const DailyClose& record) const;
+    
+    DailyClose settle(const SettlementSnapshot& snapshot) const;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "SlotMixOptimizer.h"
+#include "ParkingLot.h"
+#include "ParkingClock.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+
+#ifndef PARKING_STATIC_LAYOUT
+
+namespace {
+    std::tuple<int, int, int> keyOf(const SlotMix& mix) {
+        return std::make_tuple(mix.regular, mix.ev, mix.vip);
+    }
+    
+    std::shared_ptr<Vehicle> vehicleFor(const DemandStay& stay, size_t index) {
+        std::string plate = "SIM" + std::to_string(index);
+        switch (static_cast<VehicleType>(stay.vehicleType)) {
+            case VehicleType::MOTORCYCLE: return std::make_shared<Motorcycle>(plate, "");
+            case VehicleType::CAR: return std::make_shared<Car>(plate, "");
+            default: return std::make_shared<EV>(plate, "", stay.charging);
+        }
+    }
+}
+
+SlotMixOptimizer::SlotMixOptimizer(ThreadPool& threadPool, double penalty)
+    : pool(threadPool), rejectionPenalty(penalty) {}
+
+std::vector<DemandStay> SlotMixOptimizer::loadDemand(const PaymentHistory& history, time_t from, time_t to) {
+    std::vector<DemandStay> stays;
+    for (const auto& part : history.partitionsInRange(from, to)) {
+        MappedColumn exits(history.columnPath(part.second, "exit_time"));
+        MappedColumn entries(history.columnPath(part.second, "entry_time"));
+        MappedColumn vehicles(history.columnPath(part.second, "vehicle_type"));
+        MappedColumn slotKinds(history.columnPath(part.second, "slot_type"));
+        MappedColumn amounts(history.columnPath(part.second, "amount"));
+        size_t n = std::min({ exits.count<int64_t>(), entries.count<int64_t>(), vehicles.count<uint8_t>(),
+                              slotKinds.count<uint8_t>(), amounts.count<double>(), history.rowCount(part.second) });
+        for (size_t i = 0; i < n; i++) {
+            int64_t exit = exits.as<int64_t>()[i];
+            int64_t entry = entries.as<int64_t>()[i];
+            if (exit < from || exit >= to || entry > exit) continue;
+            if (amounts.as<double>()[i] < 0) continue; // reversed charge
+            uint8_t vehicle = vehicles.as<uint8_t>()[i];
+            bool charging = static_cast<VehicleType>(vehicle) == VehicleType::EV
+                         && static_cast<SlotKind>(slotKinds.as<uint8_t>()[i]) == SlotKind::EV;
+            stays.push_back(DemandStay{ entry, exit, vehicle, charging });
+        }
+    }
+    std::sort(stays.begin(), stays.end(), [](const DemandStay& a, const DemandStay& b) {
+        return a.entry < b.entry;
+    });
+    return stays;
+}
+
+void SlotMixOptimizer::setDemand(std::vector<DemandStay> stays) {
+    std::sort(stays.begin(), stays.end(), [](const DemandStay& a, const DemandStay& b) {
+        return a.entry < b.entry;
+    });
+    demand = std::move(stays);
+    evaluated.clear();
+}
+
+size_t SlotMixOptimizer::demandSize() const { return demand.size(); }
+
+std::vector<ParkingLayout::SlotDefinition> SlotMixOptimizer::layoutFor(const SlotMix& mix) {
+    std::vector<ParkingLayout::SlotDefinition> layout;
+    int total = mix.total();
+    int floor1 = (total + 1) / 2;
+    const struct { const char* type; const char* prefix; int count; } kinds[] = {
+        { "REGULAR", "R", mix.regular }, { "EV", "E", mix.ev }, { "VIP", "V", mix.vip }
+    };
+    for (const auto& kind : kinds) {
+        for (int i = 1; i <= kind.count; i++) {
+            int level = static_cast<int>(layout.size()) < floor1 ? 1 : 2;
+            layout.push_back({ kind.prefix + std::to_string(i), kind.type, level, true,
+                               ParkingLayout::UNKNOWN_SLOT_DISTANCE });
+        }
+    }
+    return layout;
+}
+
+LayoutScore SlotMixOptimizer::replay(const SlotMix& mix) const {
+    LayoutScore result = { mix, 0.0, demand.size(), 0, 0.0 };
+    if (demand.empty()) return result;
+    
+    VirtualClock clock(static_cast<time_t>(demand.front().entry));
+    PricingEngine pricing;
+    ParkingLot lot(0, layoutFor(mix));
+    lot.setEnforceOperatingHours(false); // recorded stays were already admitted
+    if (SystemConfig::ENABLE_DYNAMIC_PRICING) {
+        lot.setPricingEngine(&pricing);
+    }
+    
+    typedef std::pair<int64_t, int> Departure; // exit time, ticket id
+    std::priority_queue<Departure, std::vector<Departure>, std::greater<Departure>> departures;
+    auto departUntil = [&](int64_t until) {
+        while (!departures.empty() && departures.top().first <= until) {
+            clock.set(static_cast<time_t>(departures.top().first));
+            result.revenue += lot.unparkVehicle(departures.top().second);
+            departures.pop();
+        }
+    };
+    
+    for (size_t i = 0; i < demand.size(); i++) {
+        const DemandStay& stay = demand[i];
+        departUntil(stay.entry);
+        clock.set(static_cast<time_t>(stay.entry));
+        try {
+            auto ticket = lot.parkVehicle(vehicleFor(stay, i));
+            departures.push({ stay.exit, ticket->getId() });
+        } catch (const NoAvailableSlotException&) {
+            result.rejected++;
+        }
+    }
+    departUntil(std::numeric_limits<int64_t>::max());
+    
+    result.score = result.revenue - rejectionPenalty * static_cast<double>(result.rejected);
+    return result;
+}
+
+std::vector<LayoutScore> SlotMixOptimizer::evaluate(const std::vector<SlotMix>& mixes) {
+    std::vector<SlotMix> pending;
+    for (const SlotMix& mix : mixes) {
+        bool seen = evaluated.count(keyOf(mix)) > 0;
+        for (size_t i = 0; i < pending.size() && !seen; i++) {
+            seen = keyOf(pending[i]) == keyOf(mix);
+        }
+        if (!seen) pending.push_back(mix);
+    }
+    
+    // One replay per task; each runs start to finish on one worker, so the
+    // thread-local virtual clocks never interleave
+    std::vector<LayoutScore> scores(pending.size());
+    pool.parallelFor(pending.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            scores[i] = replay(pending[i]);
+        }
+    });
+    for (const LayoutScore& score : scores) {
+        evaluated[keyOf(score.mix)] = score;
+    }
+    
+    std::vector<LayoutScore> result;
+    result.reserve(mixes.size());
+    for (const SlotMix& mix : mixes) {
+        result.push_back(evaluated.at(keyOf(mix)));
+    }
+    return result;
+}
+
+LayoutScore SlotMixOptimizer::anneal(const SlotMix& start, int rounds, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pickKind(0, 2);
+    std::uniform_int_distribution<int> pickStep(1, OptimizerConfig::MAX_MOVE);
+    size_t batch = std::max<size_t>(1, pool.size() * OptimizerConfig::CANDIDATES_PER_THREAD);
+    
+    LayoutScore current = evaluate({ start }).front();
+    LayoutScore best = current;
+    double temperature = OptimizerConfig::INITIAL_TEMPERATURE * std::max(1.0, std::fabs(current.score));
+    
+    for (int round = 0; round < rounds; round++) {
+        // Neighbours move a few slots from one kind to another
+        std::vector<SlotMix> candidates;
+        for (size_t attempt = 0; candidates.size() < batch && attempt < batch * 4; attempt++) {
+            SlotMix next = current.mix;
+            int counts[3] = { next.regular, next.ev, next.vip };
+            int from = pickKind(rng);
+            int to = (from + 1 + pickKind(rng) % 2) % 3;
+            int step = std::min(pickStep(rng), counts[from] - OptimizerConfig::MIN_SLOTS_PER_KIND);
+            if (step <= 0) continue;
+            counts[from] -= step;
+            counts[to] += step;
+            candidates.push_back(SlotMix{ counts[0], counts[1], counts[2] });
+        }
+        if (candidates.empty()) break;
+        
+        for (const LayoutScore& candidate : evaluate(candidates)) {
+            double delta = candidate.score - current.score;
+            if (delta >= 0 || unit(rng) < std::exp(delta / temperature)) {
+                current = candidate;
+            }
+            if (candidate.score > best.score) {
+                best = candidate;
+            }
+        }
+        temperature *= OptimizerConfig::COOLING_RATE;
+    }
+    return best;
+}
+
+std::vector<LayoutScore> SlotMixOptimizer::ranking() const {
+    std::vector<LayoutScore> result;
+    result.reserve(evaluated.size());
+    for (const auto& entry : evaluated) {
+        result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end(), [](const LayoutScore& a, const LayoutScore& b) {
+        return a.score > b.score;
+    });
+    return result;
+}
+
+#endif
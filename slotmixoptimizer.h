@@ -0,0 +1,80 @@
+#ifndef SLOTMIXOPTIMIZER_H
+#define SLOTMIXOPTIMIZER_H
+
+#include "PaymentHistory.h"
+#include "ThreadPool.h"
+#include "ConfigParking.h"
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <tuple>
+#include <vector>
+
+// Number of slots of each kind in a candidate layout
+struct SlotMix {
+    int regular;
+    int ev;
+    int vip;
+    
+    int total() const { return regular + ev + vip; }
+};
+
+// One recorded stay, replayed as an arrival at entry and an exit at exit
+struct DemandStay {
+    int64_t entry;
+    int64_t exit;
+    uint8_t vehicleType; // VehicleType
+    bool charging;       // stayed in an EV bay, so it wants one
+};
+
+struct LayoutScore {
+    SlotMix mix;
+    double revenue;
+    size_t arrivals;
+    size_t rejected;
+    double score; // revenue minus the rejection penalty
+    
+    double rejectionRate() const { return arrivals > 0 ? static_cast<double>(rejected) / arrivals : 0.0; }
+};
+
+// Offline search for the REGULAR/EV/VIP split. Each candidate is scored by
+// replaying recorded demand through a real ParkingLot on a VirtualClock;
+// candidates are replayed in parallel on the pool and each distinct mix is
+// replayed once. Only the counts are searched; slots are laid out in the
+// built-in order (regular, EV, VIP) across two floors.
+// Not available with PARKING_STATIC_LAYOUT, where the layout is fixed.
+class SlotMixOptimizer {
+private:
+    ThreadPool& pool;
+    std::vector<DemandStay> demand; // sorted by entry
+    double rejectionPenalty;
+    std::map<std::tuple<int, int, int>, LayoutScore> evaluated;
+    
+public:
+    SlotMixOptimizer(ThreadPool& threadPool, double penalty = OptimizerConfig::REJECTION_PENALTY);
+    
+    // Stays that ended in [from, to)
+    static std::vector<DemandStay> loadDemand(const PaymentHistory& history, time_t from, time_t to);
+    void setDemand(std::vector<DemandStay> stays);
+    size_t demandSize() const;
+    
+    static std::vector<ParkingLayout::SlotDefinition> layoutFor(const SlotMix& mix);
+    
+    // Single replay on the calling thread; uncached
+    LayoutScore replay(const SlotMix& mix) const;
+    
+    // Scores all mixes, replaying the ones not seen before in parallel
+    std::vector<LayoutScore> evaluate(const std::vector<SlotMix>& mixes);
+    
+    // Simulated annealing over mixes with start.total() slots, keeping at
+    // least MIN_SLOTS_PER_KIND of each kind. Each round
+    // replays a batch of random neighbours in parallel, then walks them with
+    // the Metropolis rule. Returns the best mix seen.
+    LayoutScore anneal(const SlotMix& start, int rounds = OptimizerConfig::ANNEAL_ROUNDS,
+                       unsigned seed = OptimizerConfig::RANDOM_SEED);
+    
+    // Every mix replayed so far, best score first
+    std::vector<LayoutScore> ranking() const;
+};
+
+#endif
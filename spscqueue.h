@@ -0,0 +1,59 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer ring. Capacity is
+// rounded up to a power of two; head and tail live on separate cache lines
+// so producer and consumer do not false-share.
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> ring;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head; // next slot to read
+    alignas(64) std::atomic<size_t> tail; // next slot to write
+    alignas(64) std::atomic<bool> closed;
+    
+public:
+    explicit SpscQueue(size_t capacity) : head(0), tail(0), closed(false) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        ring.resize(size);
+        mask = size - 1;
+    }
+    
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        ring[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    void push(const T& value) {
+        while (!tryPush(value)) std::this_thread::yield();
+    }
+    
+    bool tryPop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = ring[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Producer signals that no more items will be pushed
+    void close() { closed.store(true, std::memory_order_release); }
+    
+    // True once closed and fully drained
+    bool finished() const {
+        return closed.load(std::memory_order_acquire)
+            && head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
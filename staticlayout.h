@@ -0,0 +1,155 @@
+#ifndef STATICLAYOUT_H
+#define STATICLAYOUT_H
+
+#include "ParkingSlot.h"
+#include "ConfigParking.h"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// Compile-time view of ParkingLayout::SLOT_TABLE for fixed-layout sites.
+// Slot counts, per-kind index ranges and floor capacities are constants,
+// and the capacity figures in ConfigParking.h are checked against the table
+// when this header is compiled. Build with -DPARKING_STATIC_LAYOUT to make
+// ParkingLot use StaticSlotStore instead of heap-allocated slots.
+namespace StaticLayout {
+    constexpr bool sameText(const char* a, const char* b) {
+        while (*a && *a == *b) {
+            a++;
+            b++;
+        }
+        return *a == *b;
+    }
+    
+    constexpr SlotKind kindOf(const ParkingLayout::SlotSpec& spec) {
+        return sameText(spec.type, "EV") ? SlotKind::EV
+             : sameText(spec.type, "VIP") ? SlotKind::VIP
+             : SlotKind::REGULAR;
+    }
+    
+    constexpr bool knownType(const ParkingLayout::SlotSpec& spec) {
+        return sameText(spec.type, "REGULAR") || sameText(spec.type, "EV") || sameText(spec.type, "VIP");
+    }
+    
+    constexpr size_t SLOT_COUNT = ParkingLayout::SLOT_TABLE.size();
+    constexpr size_t KINDS = 3;
+    constexpr int FLOORS = 2;
+    
+    constexpr size_t countKind(SlotKind kind) {
+        size_t count = 0;
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            if (kindOf(ParkingLayout::SLOT_TABLE[i]) == kind) count++;
+        }
+        return count;
+    }
+    
+    constexpr int countFloor(int level) {
+        int count = 0;
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            if (ParkingLayout::SLOT_TABLE[i].level == level) count++;
+        }
+        return count;
+    }
+    
+    constexpr bool validTable() {
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            const ParkingLayout::SlotSpec& spec = ParkingLayout::SLOT_TABLE[i];
+            if (!knownType(spec) || spec.level < 1 || spec.level > FLOORS) return false;
+            for (size_t j = i + 1; j < SLOT_COUNT; j++) {
+                if (sameText(spec.id, ParkingLayout::SLOT_TABLE[j].id)) return false;
+            }
+        }
+        return true;
+    }
+    
+    // Table indices grouped by kind; kind k owns KIND_ORDER[KIND_BEGIN[k] .. KIND_BEGIN[k + 1])
+    constexpr std::array<size_t, KINDS + 1> buildKindBegin() {
+        std::array<size_t, KINDS + 1> begin{};
+        for (size_t k = 0; k < KINDS; k++) {
+            begin[k + 1] = begin[k] + countKind(static_cast<SlotKind>(k));
+        }
+        return begin;
+    }
+    
+    constexpr std::array<size_t, KINDS + 1> KIND_BEGIN = buildKindBegin();
+    
+    constexpr std::array<size_t, SLOT_COUNT> buildKindOrder() {
+        std::array<size_t, SLOT_COUNT> order{};
+        std::array<size_t, KINDS + 1> next = KIND_BEGIN;
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            order[next[static_cast<size_t>(kindOf(ParkingLayout::SLOT_TABLE[i]))]++] = i;
+        }
+        return order;
+    }
+    
+    constexpr std::array<size_t, SLOT_COUNT> KIND_ORDER = buildKindOrder();
+    
+    // Inverse of KIND_ORDER: position of table index i within its kind
+    constexpr std::array<size_t, SLOT_COUNT> buildKindOffset() {
+        std::array<size_t, SLOT_COUNT> offset{};
+        for (size_t k = 0; k < KINDS; k++) {
+            for (size_t p = KIND_BEGIN[k]; p < KIND_BEGIN[k + 1]; p++) {
+                offset[KIND_ORDER[p]] = p - KIND_BEGIN[k];
+            }
+        }
+        return offset;
+    }
+    
+    constexpr std::array<size_t, SLOT_COUNT> KIND_OFFSET = buildKindOffset();
+    
+    constexpr std::array<int, FLOORS + 1> FLOOR_CAPACITY = {{ 0, countFloor(1), countFloor(2) }};
+    
+    static_assert(validTable(), "SLOT_TABLE has an unknown type, a level outside 1..2 or a duplicate id");
+    static_assert(ParkingLayout::TOTAL_CAPACITY == ParkingLayout::FLOOR_1_CAPACITY + ParkingLayout::FLOOR_2_CAPACITY,
+                  "TOTAL_CAPACITY must equal the sum of floor capacities");
+    static_assert(SLOT_COUNT == static_cast<size_t>(ParkingLayout::TOTAL_CAPACITY),
+                  "SLOT_TABLE size does not match TOTAL_CAPACITY");
+    static_assert(FLOOR_CAPACITY[1] == ParkingLayout::FLOOR_1_CAPACITY, "FLOOR_1_CAPACITY does not match SLOT_TABLE");
+    static_assert(FLOOR_CAPACITY[2] == ParkingLayout::FLOOR_2_CAPACITY, "FLOOR_2_CAPACITY does not match SLOT_TABLE");
+    static_assert(countKind(SlotKind::REGULAR) == static_cast<size_t>(ParkingLayout::REGULAR_SLOT_COUNT),
+                  "REGULAR_SLOT_COUNT does not match SLOT_TABLE");
+    static_assert(countKind(SlotKind::EV) == static_cast<size_t>(ParkingLayout::EV_SLOT_COUNT),
+                  "EV_SLOT_COUNT does not match SLOT_TABLE");
+    static_assert(countKind(SlotKind::VIP) == static_cast<size_t>(ParkingLayout::VIP_SLOT_COUNT),
+                  "VIP_SLOT_COUNT does not match SLOT_TABLE");
+}
+
+// All slots of the static layout, held by value in one array per kind.
+// Slot ids fit the small-string buffer, so constructing the store does not
+// touch the heap.
+class StaticSlotStore {
+private:
+    template <typename Slot, size_t... I>
+    static std::array<Slot, sizeof...(I)> build(size_t first, std::index_sequence<I...>) {
+        return {{ Slot(ParkingLayout::SLOT_TABLE[StaticLayout::KIND_ORDER[first + I]].id,
+                       ParkingLayout::SLOT_TABLE[StaticLayout::KIND_ORDER[first + I]].level)... }};
+    }
+    
+    static constexpr size_t REGULAR_COUNT = StaticLayout::countKind(SlotKind::REGULAR);
+    static constexpr size_t EV_COUNT = StaticLayout::countKind(SlotKind::EV);
+    static constexpr size_t VIP_COUNT = StaticLayout::countKind(SlotKind::VIP);
+    
+    std::array<RegularSlot, REGULAR_COUNT> regular;
+    std::array<EVSlot, EV_COUNT> ev;
+    std::array<VIPSlot, VIP_COUNT> vip;
+    
+public:
+    StaticSlotStore()
+        : regular(build<RegularSlot>(StaticLayout::KIND_BEGIN[0], std::make_index_sequence<REGULAR_COUNT>())),
+          ev(build<EVSlot>(StaticLayout::KIND_BEGIN[1], std::make_index_sequence<EV_COUNT>())),
+          vip(build<VIPSlot>(StaticLayout::KIND_BEGIN[2], std::make_index_sequence<VIP_COUNT>())) {}
+    StaticSlotStore(const StaticSlotStore&) = delete;
+    StaticSlotStore& operator=(const StaticSlotStore&) = delete;
+    
+    // Slot for SLOT_TABLE[index]
+    ParkingSlot& at(size_t index) {
+        size_t offset = StaticLayout::KIND_OFFSET[index];
+        switch (StaticLayout::kindOf(ParkingLayout::SLOT_TABLE[index])) {
+            case SlotKind::EV: return ev[offset];
+            case SlotKind::VIP: return vip[offset];
+            default: return regular[offset];
+        }
+    }
+};
+
+#endif
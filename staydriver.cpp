@@ -0,0 +1,123 @@
+// Stay index check: StayIndex against a brute-force scan of the same stays.
+// Usage: staydriver [stays] [queries] [seed] [directory]
+// Writes the stays through onUnpark (memtable, log, runs and compactions),
+// appends a torn record to stays.log and reopens the index, then answers
+// random 90-day plate queries and compares each with a linear scan over
+// every stay written. Ingest rate, blocks read and time per query are
+// printed. Exit code 1 if any query differs. The directory is wiped first.
+// Build: g++ -std=c++20 -O2 staydriver.cpp <modular sources except main.cpp,
+//        soalno3UAP.cpp, loadtestclient.cpp, diffharness.cpp and
+//        lotchecks.cpp> -o staydriver
+#include "StayIndex.h"
+#include "MemberRegistry.h"
+#include "ParkingClock.h"
+#include "ParkingSlot.h"
+#include "Ticket.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+struct Written {
+    std::string plate; // normalized
+    time_t entry;
+    int ticketId;
+};
+
+static double secondsSince(Clock::time_point started) {
+    return std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+static std::string normalized(const std::string& plate) {
+    char buffer[MemberTable::MAX_PLATE];
+    size_t length = MemberTable::normalize(plate, buffer);
+    return std::string(buffer, length);
+}
+
+int main(int argc, char* argv[]) {
+    size_t stayCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t queryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    unsigned seed = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 7;
+    std::string directory = argc > 4 ? argv[4] : "staydriver_index";
+    const time_t start = 1600000000;
+    const time_t spacing = 500; // seconds between entries
+    
+    std::filesystem::remove_all(directory);
+    std::mt19937 rng(seed);
+    std::vector<Written> written;
+    written.reserve(stayCount);
+    RegularSlot slot("A-01", 1);
+    
+    Clock::time_point started = Clock::now();
+    {
+        StayIndex index(directory);
+        for (size_t i = 0; i < stayCount; i++) {
+            time_t entry = start + static_cast<time_t>(i) * spacing + rng() % 400;
+            std::string plate = "B " + std::to_string(1000 + rng() % 5000) + " XY";
+            VirtualClock clock(entry);
+            Ticket ticket("A-01", std::make_shared<Car>(plate, "driver"));
+            index.onUnpark(ticket, slot, entry + 3600, 5000);
+            written.push_back({normalized(plate), entry, ticket.getId()});
+        }
+        double seconds = secondsSince(started);
+        std::cout << "Wrote " << stayCount << " stays in " << seconds << " s ("
+                  << static_cast<size_t>(stayCount / (seconds > 0 ? seconds : 1)) << " stays/s), "
+                  << index.runCount() << " runs" << std::endl;
+    }
+    
+    // A crash mid-append leaves a partial record at the end of the log
+    std::FILE* log = std::fopen((directory + "/stays.log").c_str(), "ab");
+    if (log) {
+        std::fwrite("torn", 1, 4, log);
+        std::fclose(log);
+    }
+    StayIndex index(directory);
+    std::cout << "Reopened: " << index.size() << " stays in " << index.runCount() << " runs" << std::endl;
+    
+    size_t mismatches = 0;
+    size_t hits = 0;
+    double querySeconds = 0;
+    uint64_t blocksBefore = index.blocksRead();
+    for (size_t q = 0; q < queryCount; q++) {
+        // Some plates were never written; spelling varies like operator input
+        std::string plate = "b" + std::to_string(1000 + rng() % 5200) + "xy";
+        std::string key = normalized(plate);
+        time_t to = start + static_cast<time_t>(rng() % (stayCount * spacing + 1000));
+        time_t from = to - 90 * 24 * 3600;
+        
+        Clock::time_point queried = Clock::now();
+        std::vector<StayIndex::Stay> got = index.staysFor(plate, from, to);
+        querySeconds += secondsSince(queried);
+        
+        std::vector<int> want;
+        for (const Written& stay : written) {
+            if (stay.plate == key && stay.entry >= from && stay.entry < to) want.push_back(stay.ticketId);
+        }
+        bool same = got.size() == want.size();
+        for (size_t i = 0; same && i < got.size(); i++) {
+            same = got[i].ticketId == want[i];
+        }
+        if (!same) {
+            if (mismatches < 10) {
+                std::cout << "Mismatch for " << plate << " in [" << from << ", " << to << "): "
+                          << got.size() << " stays, expected " << want.size() << std::endl;
+            }
+            mismatches++;
+        }
+        hits += got.size();
+    }
+    
+    double perQuery = queryCount > 0 ? 1.0 / queryCount : 0;
+    std::cout << "Queries: " << queryCount << ", " << mismatches << " mismatches, " << hits << " stays returned"
+              << std::endl;
+    std::cout << "Blocks read per query: " << (index.blocksRead() - blocksBefore) * perQuery
+              << ", time per query: " << querySeconds * perQuery * 1e6 << " us" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,432 @@
+#include "StayIndex.h"
+#include "Exceptions.h"
+#include "MemberRegistry.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char RUN_MAGIC[8] = { 'S', 'T', 'A', 'Y', 'R', 'U', 'N', '1' };
+    const int BLOOM_BITS_PER_RECORD = 10;
+    const int BLOOM_PROBES = 4;
+    
+    struct RunHeader {
+        char magic[8];
+        uint64_t count;
+        uint32_t blockRecords;
+        uint32_t bloomWords;
+        uint64_t reserved;
+    };
+    
+    static_assert(sizeof(StayIndex::Record) == 64, "stay records must stay 64 bytes on disk");
+    static_assert(sizeof(RunHeader) == 32, "run header must stay 32 bytes on disk");
+    
+    uint64_t plateHash(const char (&plate)[16]) {
+        // Run files store Bloom filters built from this value; keep it stable
+        return MemberTable::mixPlate(plate, strnlen(plate, sizeof(plate))) | 1;
+    }
+    
+    bool parseRunName(const std::string& name, uint64_t& sequence) {
+        if (name.size() < 9 || name.compare(0, 4, "run-") != 0 || name.compare(name.size() - 4, 4, ".sst") != 0) {
+            return false;
+        }
+        sequence = 0;
+        for (size_t i = 4; i < name.size() - 4; i++) {
+            if (name[i] < '0' || name[i] > '9') return false;
+            sequence = sequence * 10 + (name[i] - '0');
+        }
+        return true;
+    }
+    
+    void syncFile(const std::string& path) {
+#ifndef _WIN32
+        FILE* handle = std::fopen(path.c_str(), "rb");
+        if (handle) {
+            fsync(fileno(handle));
+            std::fclose(handle);
+        }
+#endif
+    }
+}
+
+StayIndex::StayIndex(const std::string& directory, size_t memtableRecords, size_t blockSize, size_t compactionFanIn)
+    : root(directory), memtableLimit(std::max<size_t>(memtableRecords, 1)),
+      blockRecords(std::max<size_t>(blockSize, 1)), fanIn(std::max<size_t>(compactionFanIn, 2)),
+      nextSequence(1), readCount(0) {
+    fs::create_directories(root);
+    
+    // Leftover temporaries are runs whose rename never happened
+    for (const auto& entry : fs::directory_iterator(root)) {
+        std::string name = entry.path().filename().string();
+        uint64_t sequence;
+        if (entry.path().extension() == ".tmp") {
+            fs::remove(entry.path());
+        } else if (parseRunName(name, sequence)) {
+            runs.push_back(openRun(entry.path().string(), sequence));
+            nextSequence = std::max(nextSequence, sequence + 1);
+        }
+    }
+    std::sort(runs.begin(), runs.end(), [](const std::unique_ptr<Run>& a, const std::unique_ptr<Run>& b) {
+        return a->sequence < b->sequence;
+    });
+    
+    // Replay stays that closed after the last run was written; a torn
+    // final record is dropped
+    std::string logPath = root + "/stays.log";
+    std::error_code ec;
+    uint64_t logSize = fs::file_size(logPath, ec);
+    if (!ec) {
+        if (logSize % sizeof(Record) != 0) {
+            logSize -= logSize % sizeof(Record);
+            fs::resize_file(logPath, logSize);
+        }
+        std::ifstream in(logPath, std::ios::binary);
+        memtable.resize(logSize / sizeof(Record));
+        in.read(reinterpret_cast<char*>(memtable.data()), logSize);
+    }
+    log.open(logPath, std::ios::binary | std::ios::app);
+    if (!log) {
+        throw ParkingException("Cannot open stay log: " + logPath);
+    }
+}
+
+StayIndex::Key StayIndex::keyOf(const Record& record) {
+    Key key;
+    std::memcpy(key.plate, record.plate, sizeof(key.plate));
+    key.entryTime = record.entryTime;
+    key.ticketId = record.ticketId;
+    key.reserved = 0;
+    return key;
+}
+
+bool StayIndex::less(const Key& a, const Key& b) {
+    int plate = std::memcmp(a.plate, b.plate, sizeof(a.plate));
+    if (plate != 0) return plate < 0;
+    if (a.entryTime != b.entryTime) return a.entryTime < b.entryTime;
+    return a.ticketId < b.ticketId;
+}
+
+void StayIndex::bloomAdd(std::vector<uint64_t>& bloom, uint64_t hash) {
+    uint64_t bits = bloom.size() * 64;
+    uint64_t step = (hash >> 32) | 1;
+    for (int i = 0; i < BLOOM_PROBES; i++) {
+        uint64_t bit = (hash + i * step) % bits;
+        bloom[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool StayIndex::bloomMayContain(const std::vector<uint64_t>& bloom, uint64_t hash) {
+    uint64_t bits = bloom.size() * 64;
+    uint64_t step = (hash >> 32) | 1;
+    for (int i = 0; i < BLOOM_PROBES; i++) {
+        uint64_t bit = (hash + i * step) % bits;
+        if (!(bloom[bit >> 6] & (1ULL << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+StayIndex::Stay StayIndex::toStay(const Record& record) {
+    Stay stay;
+    stay.plate.assign(record.plate, strnlen(record.plate, sizeof(record.plate)));
+    stay.entryTime = static_cast<time_t>(record.entryTime);
+    stay.exitTime = static_cast<time_t>(record.exitTime);
+    stay.ticketId = record.ticketId;
+    stay.amount = record.amount;
+    stay.slotId.assign(record.slotId, strnlen(record.slotId, sizeof(record.slotId)));
+    stay.vehicleType = record.vehicleType;
+    stay.slotType = record.slotType;
+    stay.floor = record.floor;
+    return stay;
+}
+
+std::string StayIndex::runPath(uint64_t sequence) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "run-%06llu.sst", static_cast<unsigned long long>(sequence));
+    return root + "/" + name;
+}
+
+std::unique_ptr<StayIndex::Run> StayIndex::openRun(const std::string& path, uint64_t sequence) const {
+    std::unique_ptr<Run> run(new Run());
+    run->path = path;
+    run->sequence = sequence;
+    run->file.open(path, std::ios::binary);
+    
+    RunHeader header;
+    if (!run->file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, RUN_MAGIC, sizeof(RUN_MAGIC)) != 0 || header.blockRecords == 0 ||
+        header.bloomWords == 0) {
+        throw ParkingException("Corrupt stay run: " + path);
+    }
+    run->count = header.count;
+    run->blockRecords = header.blockRecords;
+    size_t blocks = (header.count + header.blockRecords - 1) / header.blockRecords;
+    uint64_t expected = sizeof(header) + header.count * sizeof(Record) +
+                        header.bloomWords * sizeof(uint64_t) + blocks * sizeof(Key);
+    std::error_code ec;
+    if (fs::file_size(path, ec) != expected || ec) {
+        throw ParkingException("Corrupt stay run: " + path);
+    }
+    
+    // Filter and block index follow the records
+    run->bloom.resize(header.bloomWords);
+    run->firstKeys.resize(blocks);
+    run->file.seekg(sizeof(header) + header.count * sizeof(Record));
+    run->file.read(reinterpret_cast<char*>(run->bloom.data()), header.bloomWords * sizeof(uint64_t));
+    run->file.read(reinterpret_cast<char*>(run->firstKeys.data()), blocks * sizeof(Key));
+    if (!run->file) {
+        throw ParkingException("Corrupt stay run: " + path);
+    }
+    return run;
+}
+
+template <typename Source>
+std::unique_ptr<StayIndex::Run> StayIndex::writeRun(uint64_t sequence, uint64_t expected, Source next) const {
+    std::string path = runPath(sequence);
+    std::string temp = path + ".tmp";
+    RunHeader header = {};
+    std::memcpy(header.magic, RUN_MAGIC, sizeof(RUN_MAGIC));
+    header.blockRecords = static_cast<uint32_t>(blockRecords);
+    header.bloomWords = static_cast<uint32_t>(std::max<uint64_t>(1, (expected * BLOOM_BITS_PER_RECORD + 63) / 64));
+    std::vector<uint64_t> bloom(header.bloomWords);
+    std::vector<Key> firstKeys;
+    
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw ParkingException("Cannot write stay run: " + temp);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        
+        // Inputs may repeat a stay (a log replayed after its run was
+        // written); only the first copy is kept
+        Record record;
+        Key last = {};
+        while (next(record)) {
+            Key key = keyOf(record);
+            if (header.count > 0 && !less(last, key)) continue;
+            if (header.count % blockRecords == 0) {
+                firstKeys.push_back(key);
+            }
+            bloomAdd(bloom, plateHash(record.plate));
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            last = key;
+            header.count++;
+        }
+        out.write(reinterpret_cast<const char*>(bloom.data()), bloom.size() * sizeof(uint64_t));
+        out.write(reinterpret_cast<const char*>(firstKeys.data()), firstKeys.size() * sizeof(Key));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (!out) {
+            throw ParkingException("Cannot write stay run: " + temp);
+        }
+    }
+    
+    // Make the contents durable before the rename publishes them
+    syncFile(temp);
+    fs::rename(temp, path);
+    return openRun(path, sequence);
+}
+
+void StayIndex::scanRun(const Run& run, const Key& low, const Key& high, std::vector<Record>& out) const {
+    if (!bloomMayContain(run.bloom, plateHash(low.plate))) return;
+    
+    // Start in the last block whose first key is not above low, then read
+    // consecutive blocks until a key reaches high
+    auto first = std::upper_bound(run.firstKeys.begin(), run.firstKeys.end(), low, less);
+    size_t block = first == run.firstKeys.begin() ? 0 : (first - run.firstKeys.begin()) - 1;
+    std::vector<Record> buffer(run.blockRecords);
+    run.file.clear();
+    run.file.seekg(sizeof(RunHeader) + block * run.blockRecords * sizeof(Record));
+    for (; block < run.firstKeys.size() && less(run.firstKeys[block], high); block++) {
+        size_t count = std::min<uint64_t>(run.blockRecords, run.count - block * run.blockRecords);
+        if (!run.file.read(reinterpret_cast<char*>(buffer.data()), count * sizeof(Record))) return;
+        readCount++;
+        for (size_t i = 0; i < count; i++) {
+            Key key = keyOf(buffer[i]);
+            if (less(key, low)) continue;
+            if (!less(key, high)) return;
+            out.push_back(buffer[i]);
+        }
+    }
+}
+
+void StayIndex::append(const Record& record) {
+    log.write(reinterpret_cast<const char*>(&record), sizeof(record)).flush();
+    memtable.push_back(record);
+    if (memtable.size() >= memtableLimit) {
+        flush();
+    }
+}
+
+void StayIndex::onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) {
+    Record record = {};
+    if (MemberTable::normalize(ticket.getVehicle()->getPlate(), record.plate) == 0) return;
+    record.entryTime = ticket.getEntryTime();
+    record.exitTime = when;
+    record.amount = fee;
+    record.ticketId = ticket.getId();
+    std::string slotId = slot.getId();
+    std::memcpy(record.slotId, slotId.data(), std::min(slotId.size(), sizeof(record.slotId)));
+    record.vehicleType = static_cast<uint8_t>(ticket.getVehicle()->getType());
+    record.slotType = static_cast<uint8_t>(slot.getKind());
+    record.floor = static_cast<uint8_t>(slot.getLevel());
+    try {
+        append(record);
+    } catch (const std::exception&) {
+        // The stay is in the log; the next flush retries the run
+    }
+}
+
+void StayIndex::flush() {
+    if (memtable.empty()) return;
+    
+    std::vector<Record> sorted(memtable);
+    std::sort(sorted.begin(), sorted.end(), [](const Record& a, const Record& b) {
+        return less(keyOf(a), keyOf(b));
+    });
+    size_t position = 0;
+    runs.push_back(writeRun(nextSequence, sorted.size(), [&](Record& record) {
+        if (position == sorted.size()) return false;
+        record = sorted[position++];
+        return true;
+    }));
+    nextSequence++;
+    
+    // The run is durable, so the log can start over
+    memtable.clear();
+    log.close();
+    log.open(root + "/stays.log", std::ios::binary | std::ios::trunc);
+    compact();
+}
+
+void StayIndex::compact() {
+    // Size tiers: tier t holds runs of about memtableLimit * fanIn^t stays.
+    // Merging fanIn runs of one tier yields a run of the next.
+    for (;;) {
+        std::vector<std::vector<size_t>> tiers;
+        for (size_t i = 0; i < runs.size(); i++) {
+            size_t tier = 0;
+            for (uint64_t limit = memtableLimit * fanIn; runs[i]->count >= limit; limit *= fanIn) {
+                tier++;
+            }
+            if (tiers.size() <= tier) tiers.resize(tier + 1);
+            tiers[tier].push_back(i);
+        }
+        auto full = std::find_if(tiers.begin(), tiers.end(), [&](const std::vector<size_t>& tier) {
+            return tier.size() >= fanIn;
+        });
+        if (full == tiers.end()) return;
+        full->resize(fanIn);
+        merge(*full);
+    }
+}
+
+void StayIndex::merge(const std::vector<size_t>& selected) {
+    // One cursor per input run, each reading its run block by block
+    struct Cursor {
+        Run* run;
+        std::vector<Record> buffer;
+        size_t position;
+        uint64_t consumed;
+    };
+    std::vector<Cursor> cursors;
+    uint64_t expected = 0;
+    for (size_t index : selected) {
+        Run* run = runs[index].get();
+        run->file.clear();
+        run->file.seekg(sizeof(RunHeader));
+        cursors.push_back(Cursor{ run, {}, 0, 0 });
+        expected += run->count;
+    }
+    auto refill = [&](Cursor& cursor) {
+        size_t count = std::min<uint64_t>(cursor.run->blockRecords, cursor.run->count - cursor.consumed);
+        cursor.buffer.resize(count);
+        cursor.position = 0;
+        if (!cursor.run->file.read(reinterpret_cast<char*>(cursor.buffer.data()), count * sizeof(Record))) {
+            throw ParkingException("Cannot read stay run: " + cursor.run->path);
+        }
+    };
+    
+    std::unique_ptr<Run> merged = writeRun(nextSequence, expected, [&](Record& record) {
+        Cursor* best = nullptr;
+        for (Cursor& cursor : cursors) {
+            if (cursor.consumed == cursor.run->count) continue;
+            if (cursor.position == cursor.buffer.size()) refill(cursor);
+            if (!best || less(keyOf(cursor.buffer[cursor.position]), keyOf(best->buffer[best->position]))) {
+                best = &cursor;
+            }
+        }
+        if (!best) return false;
+        record = best->buffer[best->position++];
+        best->consumed++;
+        return true;
+    });
+    nextSequence++;
+    
+    // The merged run is published; drop its inputs. A crash here leaves
+    // duplicates that queries and the next merge skip.
+    std::vector<std::unique_ptr<Run>> kept;
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (std::find(selected.begin(), selected.end(), i) == selected.end()) {
+            kept.push_back(std::move(runs[i]));
+        } else {
+            runs[i]->file.close();
+            fs::remove(runs[i]->path);
+        }
+    }
+    kept.push_back(std::move(merged));
+    runs.swap(kept);
+}
+
+std::vector<StayIndex::Stay> StayIndex::staysFor(const std::string& plate, time_t from, time_t to) const {
+    std::vector<Stay> result;
+    Key low = {};
+    if (MemberTable::normalize(plate, low.plate) == 0 || from >= to) return result;
+    low.entryTime = from;
+    low.ticketId = INT_MIN;
+    Key high = low;
+    high.entryTime = to;
+    
+    std::vector<Record> found;
+    for (const auto& run : runs) {
+        scanRun(*run, low, high, found);
+    }
+    for (const Record& record : memtable) {
+        Key key = keyOf(record);
+        if (!less(key, low) && less(key, high)) found.push_back(record);
+    }
+    
+    std::sort(found.begin(), found.end(), [](const Record& a, const Record& b) {
+        return less(keyOf(a), keyOf(b));
+    });
+    for (size_t i = 0; i < found.size(); i++) {
+        if (i > 0 && !less(keyOf(found[i - 1]), keyOf(found[i]))) continue;
+        result.push_back(toStay(found[i]));
+    }
+    return result;
+}
+
+size_t StayIndex::runCount() const {
+    return runs.size();
+}
+
+uint64_t StayIndex::size() const {
+    uint64_t total = memtable.size();
+    for (const auto& run : runs) {
+        total += run->count;
+    }
+    return total;
+}
+
+uint64_t StayIndex::blocksRead() const {
+    return readCount;
+}
@@ -0,0 +1,116 @@
+#ifndef STAYINDEX_H
+#define STAYINDEX_H
+
+#include "ParkingObserver.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Persistent index of closed stays keyed by (plate, entry time), for
+// questions like "every stay of plate X in the last 90 days" over years of
+// history. Organized as a small log-structured merge tree:
+//   <root>/stays.log        closed stays not yet in a run, replayed on open
+//   <root>/run-NNNNNN.sst   immutable runs sorted by (plate, entry time)
+// A run holds 64-byte records in blocks of STAY_BLOCK_RECORDS, followed by
+// a Bloom filter over its plates and the first key of every block; both are
+// kept in memory, so a lookup reads only the blocks that can match, usually
+// one seek per run whose filter admits the plate. Runs of similar size are
+// merged STAY_COMPACTION_FANIN at a time, keeping the run count
+// logarithmic in the history size. Used from the lot's thread only.
+class StayIndex : public ParkingObserver {
+public:
+    struct Stay {
+        std::string plate; // normalized
+        time_t entryTime;
+        time_t exitTime;
+        int ticketId;
+        double amount;
+        std::string slotId;
+        uint8_t vehicleType;
+        uint8_t slotType;
+        uint8_t floor;
+    };
+    
+    // On-disk layout of one stay; the plate is zero-padded
+    struct Record {
+        char plate[16];
+        int64_t entryTime;
+        int64_t exitTime;
+        double amount;
+        int32_t ticketId;
+        char slotId[12];
+        uint8_t vehicleType;
+        uint8_t slotType;
+        uint8_t floor;
+        uint8_t reserved[5];
+    };
+    
+private:
+    struct Key {
+        char plate[16];
+        int64_t entryTime;
+        int32_t ticketId;
+        int32_t reserved;
+    };
+    
+    struct Run {
+        std::string path;
+        uint64_t sequence;
+        uint64_t count;
+        uint32_t blockRecords;
+        std::vector<uint64_t> bloom;
+        std::vector<Key> firstKeys; // one per block
+        mutable std::ifstream file;
+    };
+    
+    std::string root;
+    size_t memtableLimit;
+    size_t blockRecords;
+    size_t fanIn;
+    std::vector<Record> memtable; // unsorted, mirrors stays.log
+    std::vector<std::unique_ptr<Run>> runs;
+    uint64_t nextSequence;
+    std::ofstream log;
+    mutable uint64_t readCount;
+    
+    static Key keyOf(const Record& record);
+    static bool less(const Key& a, const Key& b);
+    static bool bloomMayContain(const std::vector<uint64_t>& bloom, uint64_t hash);
+    static void bloomAdd(std::vector<uint64_t>& bloom, uint64_t hash);
+    static Stay toStay(const Record& record);
+    
+    std::string runPath(uint64_t sequence) const;
+    std::unique_ptr<Run> openRun(const std::string& path, uint64_t sequence) const;
+    // Writes sorted, duplicate-free records as run `sequence` and opens it
+    template <typename Source>
+    std::unique_ptr<Run> writeRun(uint64_t sequence, uint64_t expected, Source next) const;
+    void scanRun(const Run& run, const Key& low, const Key& high, std::vector<Record>& out) const;
+    void append(const Record& record);
+    void compact();
+    void merge(const std::vector<size_t>& selected);
+    
+public:
+    explicit StayIndex(const std::string& directory,
+                       size_t memtableRecords = 4096, size_t blockSize = 64, size_t compactionFanIn = 4);
+    StayIndex(const StayIndex&) = delete;
+    StayIndex& operator=(const StayIndex&) = delete;
+    
+    void onUnpark(const Ticket& ticket, const ParkingSlot& slot, time_t when, double fee) override;
+    
+    // Stays of the plate that entered in [from, to), oldest first
+    std::vector<Stay> staysFor(const std::string& plate, time_t from, time_t to) const;
+    
+    // Writes the memtable out as a run and compacts if a tier is full.
+    // Throws ParkingException if the run cannot be written.
+    void flush();
+    size_t runCount() const;
+    uint64_t size() const;
+    // Block reads issued by queries since construction
+    uint64_t blocksRead() const;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "ThreadPool.h"
+
+namespace {
+    // Index of the worker owning the current thread, or -1 outside the pool
+    thread_local long currentWorker = -1;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping(false), pending(0), nextQueue(0) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const { return workers.size(); }
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t target = currentWorker >= 0
+        ? static_cast<size_t>(currentWorker)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popTask(size_t home, std::function<void()>& task) {
+    {
+        WorkQueue& own = *queues[home];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkQueue& victim = *queues[(home + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+    size_t home = currentWorker >= 0 ? static_cast<size_t>(currentWorker) : 0;
+    if (!popTask(home, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentWorker = static_cast<long>(index);
+    std::function<void()> task;
+    while (true) {
+        if (popTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if (stopping && pending == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (chunkSize == 0) chunkSize = 1;
+    
+    struct Join {
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining;
+        std::exception_ptr error; // first chunk failure
+    };
+    Join join;
+    join.remaining = (count + chunkSize - 1) / chunkSize;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+        submit([&body, &join, begin, end] {
+            std::exception_ptr error;
+            try {
+                body(begin, end);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(join.mutex);
+            if (error && !join.error) join.error = error;
+            if (--join.remaining == 0) join.done.notify_all();
+        });
+    }
+    
+    // Chunks still queued are run here; once none are, the rest are running
+    // on workers and only need waiting for
+    while (runPendingTask()) {
+        std::lock_guard<std::mutex> lock(join.mutex);
+        if (join.remaining == 0) break;
+    }
+    std::unique_lock<std::mutex> lock(join.mutex);
+    join.done.wait(lock, [&join] { return join.remaining == 0; });
+    if (join.error) std::rethrow_exception(join.error);
+}
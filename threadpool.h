@@ -0,0 +1,54 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing pool. Each worker pops from the back of its own
+// deque and steals from the front of the others when it runs dry.
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextQueue;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    
+    bool popTask(size_t home, std::function<void()>& task);
+    void workerLoop(size_t index);
+
+public:
+    explicit ThreadPool(size_t threadCount = 0); // 0 = hardware_concurrency
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    size_t size() const;
+    void submit(std::function<void()> task);
+    
+    // Runs one queued task on the calling thread; false if none was queued.
+    bool runPendingTask();
+    
+    // Calls body(begin, end) on chunks of [0, count) and blocks until all
+    // chunks finished. The caller helps execute tasks while any are queued,
+    // then sleeps until the last chunk is done. If a chunk throws, the first
+    // exception is rethrown here once every chunk has finished.
+    void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& body);
+};
+
+#endif
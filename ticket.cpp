@@ -1,10 +1,15 @@
 #include "Ticket.h"
+#include "ConfigParking.h"
+#include "ParkingClock.h"
 #include <ctime>
 
 int Ticket::nextId = 1000;
 
 Ticket::Ticket(const std::string& slotId, std::shared_ptr<Vehicle> v) 
-    : id(nextId++), slotId(slotId), vehicle(v), entryTime(time(0)), paid(false) {}
+    : id(nextId++), slotId(slotId), vehicle(v), entryTime(ParkingClock::now()), paid(false), hourlyRate(0), member(false) {}
+
+Ticket::Ticket(int ticketId, const std::string& slotId, std::shared_ptr<Vehicle> v) 
+    : id(ticketId), slotId(slotId), vehicle(v), entryTime(ParkingClock::now()), paid(false), hourlyRate(0), member(false) {}
 
 int Ticket::getId() const { return id; }
 std::string Ticket::getSlotId() const { return slotId; }
@@ -13,15 +18,60 @@ time_t Ticket::getEntryTime() const { return entryTime; }
 bool Ticket::isPaid() const { return paid; }
 void Ticket::markPaid() { paid = true; }
 
+double Ticket::getHourlyRate() const { return hourlyRate; }
+void Ticket::setHourlyRate(double rate) { hourlyRate = rate; }
+
+bool Ticket::isMember() const { return member; }
+void Ticket::setMember(bool isMember) { member = isMember; }
+
+bool Ticket::inVipSlot() const {
+    return slotId.find("V") != std::string::npos;
+}
+
+double Ticket::chargingFee() const {
+    auto ev = std::dynamic_pointer_cast<EV>(vehicle);
+    return (ev && ev->needsCharging() && !inVipSlot()) ? ParkingRate::EV_CHARGING_FEE : 0.0;
+}
+
+void Ticket::getTariff(double& ratePerHour, double& flatFee) const {
+    flatFee = chargingFee();
+    if (hourlyRate > 0) {
+        ratePerHour = hourlyRate;
+    } else if (inVipSlot()) {
+        ratePerHour = ParkingRate::CAR_RATE_PER_HOUR * (1.0 + ParkingRate::VIP_SURCHARGE_PERCENTAGE / 100.0);
+    } else {
+        switch (vehicle->getType()) {
+            case VehicleType::MOTORCYCLE: ratePerHour = ParkingRate::MOTORCYCLE_RATE_PER_HOUR; break;
+            case VehicleType::CAR: ratePerHour = ParkingRate::CAR_RATE_PER_HOUR; break;
+            default: ratePerHour = ParkingRate::EV_RATE_PER_HOUR; break;
+        }
+    }
+    if (member) {
+        double factor = 1.0 - ParkingRate::MEMBER_DISCOUNT_PERCENTAGE / 100.0;
+        ratePerHour *= factor;
+        flatFee *= factor;
+    }
+}
+
 double Ticket::calculateFee(time_t exitTime) const {
     int duration = (exitTime - entryTime) / 3600;
     if (duration < 1) duration = 1;
+    double memberFactor = member ? 1.0 - ParkingRate::MEMBER_DISCOUNT_PERCENTAGE / 100.0 : 1.0;
+    
+    // Dynamic pricing: the rate was fixed at entry, surcharges included
+    if (hourlyRate > 0) {
+        double fee = duration * hourlyRate + chargingFee();
+        if (duration > ParkingRate::LONG_TERM_DISCOUNT_HOURS) {
+            fee *= 1.0 - ParkingRate::LONG_TERM_DISCOUNT_PERCENTAGE / 100.0;
+        }
+        return fee * memberFactor;
+    }
     
     // Check if it's in VIP slot
-    if (slotId.find("V") != std::string::npos) { // VIP slot starts with V
+    if (inVipSlot()) {
         VIPSlot vip("", 0);
-        return vip.calculateRate(duration);
+        return vip.calculateRate(duration) * memberFactor;
     }
     
-    return vehicle->calculateRate(duration);
+    return vehicle->calculateRate(duration) * memberFactor;
 }
@@ -14,8 +14,15 @@ private:
     std::shared_ptr<Vehicle> vehicle;
     time_t entryTime;
     bool paid;
+    double hourlyRate; // rate quoted at entry, 0 = static tariff
+    bool member;       // member discount applies
+    
+    bool inVipSlot() const; // VIP slot ids start with V
+    // EV charging fee; never charged in a VIP slot, whatever the pricing
+    double chargingFee() const;
 public:
     Ticket(const std::string& slotId, std::shared_ptr<Vehicle> v);
+    Ticket(int ticketId, const std::string& slotId, std::shared_ptr<Vehicle> v);
     
     int getId() const;
     std::string getSlotId() const;
@@ -24,6 +31,16 @@ public:
     bool isPaid() const;
     void markPaid();
     
+    double getHourlyRate() const;
+    void setHourlyRate(double rate);
+    
+    bool isMember() const;
+    void setMember(bool isMember);
+    
+    // Reduces the tariff to fee = hours * ratePerHour + flatFee (before the
+    // long-term discount), matching calculateFee
+    void getTariff(double& ratePerHour, double& flatFee) const;
+    
     double calculateFee(time_t exitTime) const;
 };
 
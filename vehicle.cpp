@@ -1,9 +1,11 @@
 #include "Vehicle.h"
 #include "Exceptions.h"
+#include "ConfigParking.h"
+#include <cmath>
 #include <iostream>
 
 Vehicle::Vehicle(const std::string& p, const std::string& o, VehicleType t) 
-    : plate(p), owner(o), type(t), arrivalTime(0) {}
+    : plate(p), owner(o), type(t), arrivalTime(0), attributes(VehicleAttribute::NONE) {}
 
 Vehicle::~Vehicle() {}
 
@@ -14,6 +16,9 @@ time_t Vehicle::getArrivalTime() const { return arrivalTime; }
 
 void Vehicle::setArrivalTime(time_t t) { arrivalTime = t; }
 
+unsigned Vehicle::getAttributes() const { return attributes; }
+void Vehicle::setAttributes(unsigned mask) { attributes = mask; }
+
 double Vehicle::calculateRate(time_t startTime, time_t endTime) const {
     int duration = (endTime - startTime) / 3600;
     if (duration < 1) duration = 1;
@@ -55,10 +60,26 @@ double Car::calculateRate(int durationHours) const {
 
 // EV implementation
 EV::EV(const std::string& p, const std::string& o, bool charging) 
-    : Vehicle(p, o, VehicleType::EV), chargingRequired(charging) {}
+    : Vehicle(p, o, VehicleType::EV), chargingRequired(charging), energyRequestKWh(0), plannedStayMinutes(0) {}
 
 bool EV::needsCharging() const { return chargingRequired; }
 
+void EV::setChargingRequest(double energyKWh, int stayMinutes) {
+    if (!validChargingRequest(energyKWh, stayMinutes)) {
+        throw ParkingException("Invalid charging request");
+    }
+    energyRequestKWh = energyKWh;
+    plannedStayMinutes = stayMinutes;
+}
+
+bool EV::validChargingRequest(double energyKWh, double stayMinutes) {
+    return std::isfinite(energyKWh) && energyKWh >= 0 && energyKWh <= ChargingConfig::MAX_ENERGY_REQUEST_KWH
+        && std::isfinite(stayMinutes) && stayMinutes >= 0 && stayMinutes <= ChargingConfig::MAX_STAY_HOURS * 60;
+}
+
+double EV::getEnergyRequest() const { return energyRequestKWh; }
+int EV::getPlannedStayMinutes() const { return plannedStayMinutes; }
+
 double EV::calculateRate(int durationHours) const {
     double rate = durationHours * 4000;
     if (chargingRequired) {
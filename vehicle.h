@@ -6,12 +6,23 @@
 
 enum class VehicleType { MOTORCYCLE, CAR, EV };
 
+// Vehicle requirements as bits. Slots advertise the same bits as
+// capabilities, so a slot fits when (requirements & ~capabilities) == 0.
+namespace VehicleAttribute {
+    const unsigned NONE = 0;
+    const unsigned TALL = 1u << 0;       // over 2.0 m, needs 2.2 m clearance
+    const unsigned OVERSIZED = 1u << 1;  // needs a VIP-size bay (3.0 x 6.0 m)
+    const unsigned ACCESSIBLE = 1u << 2; // needs a disabled-parking bay
+    const unsigned ALL = TALL | OVERSIZED | ACCESSIBLE;
+}
+
 class Vehicle {
 protected:
     std::string plate;
     std::string owner;
     time_t arrivalTime;
     VehicleType type;
+    unsigned attributes;
 public:
     Vehicle(const std::string& p, const std::string& o, VehicleType t);
     virtual ~Vehicle();
@@ -23,6 +34,9 @@ public:
     
     void setArrivalTime(time_t t);
     
+    unsigned getAttributes() const;
+    void setAttributes(unsigned mask);
+    
     virtual double calculateRate(int durationHours) const = 0;
     virtual double calculateRate(time_t startTime, time_t endTime) const;
     virtual std::string getTypeName() const;
@@ -43,9 +57,20 @@ public:
 class EV : public Vehicle {
 private:
     bool chargingRequired;
+    double energyRequestKWh; // 0 = ChargingConfig default
+    int plannedStayMinutes;  // 0 = ChargingConfig default
 public:
     EV(const std::string& p, const std::string& o, bool charging);
     bool needsCharging() const;
+    
+    // What the driver asked for at registration; read when the vehicle
+    // gets its slot, so it also applies after a wait on the waitlist.
+    // Throws ParkingException unless validChargingRequest holds.
+    void setChargingRequest(double energyKWh, int stayMinutes);
+    // Finite, non-negative and within ChargingConfig's maximums
+    static bool validChargingRequest(double energyKWh, double stayMinutes);
+    double getEnergyRequest() const;
+    int getPlannedStayMinutes() const;
     double calculateRate(int durationHours) const override;
 };
 
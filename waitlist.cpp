@@ -0,0 +1,117 @@
+#include "Waitlist.h"
+#include "ConfigParking.h"
+#include <algorithm>
+
+Waitlist::Waitlist()
+    : nextWaitId(1), nextSeq(0), enqueuedCount(0), assignedCount(0), cancelledCount(0), longestQueue(0),
+      totalWaitSeconds(0), maxWaitSeconds(0) {}
+
+int Waitlist::priorityOf(const Vehicle& v) {
+    // Drivers needing the accessible bays go ahead of everyone in their queue
+    return (v.getAttributes() & VehicleAttribute::ACCESSIBLE) ? 1 : 0;
+}
+
+WaitClass Waitlist::classify(const Vehicle& v, bool holdsVipReservation) {
+    if (holdsVipReservation) return WaitClass::VIP;
+    auto ev = dynamic_cast<const EV*>(&v);
+    if (ev && ev->needsCharging()) return WaitClass::EV_CHARGING;
+    return WaitClass::REGULAR;
+}
+
+int Waitlist::enqueue(std::shared_ptr<Vehicle> v, WaitClass waitClass, time_t now) {
+    int waitId = nextWaitId++;
+    Key key = { priorityOf(*v), nextSeq++, waitId };
+    queues[static_cast<int>(waitClass)].insert(key);
+    waiting[waitId] = Waiting{ v, waitClass, key, now };
+    enqueuedCount++;
+    longestQueue = std::max(longestQueue, waiting.size());
+    return waitId;
+}
+
+bool Waitlist::cancel(int waitId) {
+    auto found = waiting.find(waitId);
+    if (found == waiting.end()) return false;
+    queues[static_cast<int>(found->second.waitClass)].erase(found->second.key);
+    waiting.erase(found);
+    cancelledCount++;
+    return true;
+}
+
+int Waitlist::next(const ParkingSlot& slot) const {
+    // Queues each slot kind serves, in order of preference. EV bays go to
+    // charging EVs first; elsewhere they come last since they would park
+    // without charging.
+    WaitClass order[3];
+    size_t count = 0;
+    switch (slot.getKind()) {
+        case SlotKind::EV:
+            order[count++] = WaitClass::EV_CHARGING;
+            order[count++] = WaitClass::REGULAR;
+            break;
+        case SlotKind::VIP:
+            order[count++] = WaitClass::VIP;
+            order[count++] = WaitClass::REGULAR;
+            order[count++] = WaitClass::EV_CHARGING;
+            break;
+        default:
+            order[count++] = WaitClass::REGULAR;
+            order[count++] = WaitClass::EV_CHARGING;
+            break;
+    }
+    
+    for (size_t q = 0; q < count; q++) {
+        const std::set<Key>& queue = queues[static_cast<int>(order[q])];
+        int depth = 0;
+        for (auto it = queue.begin(); it != queue.end() && depth < SystemConfig::WAITLIST_SCAN_DEPTH; ++it, ++depth) {
+            const Vehicle& v = *waiting.at(it->waitId).vehicle;
+            if (slot.fits(v) && slot.canPark(v)) {
+                return it->waitId;
+            }
+        }
+    }
+    return -1;
+}
+
+std::shared_ptr<Vehicle> Waitlist::vehicleOf(int waitId) const {
+    auto found = waiting.find(waitId);
+    return found != waiting.end() ? found->second.vehicle : nullptr;
+}
+
+void Waitlist::assigned(int waitId, int ticketId, time_t now) {
+    auto found = waiting.find(waitId);
+    if (found == waiting.end()) return;
+    double waited = static_cast<double>(now - found->second.since);
+    totalWaitSeconds += waited;
+    maxWaitSeconds = std::max(maxWaitSeconds, waited);
+    queues[static_cast<int>(found->second.waitClass)].erase(found->second.key);
+    waiting.erase(found);
+    assignedCount++;
+    assignments[waitId] = ticketId;
+    assignmentOrder.push_back(waitId);
+    if (assignmentOrder.size() > SystemConfig::WAITLIST_ASSIGNMENT_HISTORY) {
+        assignments.erase(assignmentOrder.front());
+        assignmentOrder.pop_front();
+    }
+}
+
+int Waitlist::ticketFor(int waitId) const {
+    auto found = assignments.find(waitId);
+    if (found != assignments.end()) return found->second;
+    return waiting.count(waitId) ? 0 : -1;
+}
+
+size_t Waitlist::size() const { return waiting.size(); }
+
+Waitlist::Stats Waitlist::getStats() const {
+    Stats stats;
+    for (int c = 0; c < CLASSES; c++) {
+        stats.waiting[c] = queues[c].size();
+    }
+    stats.enqueued = enqueuedCount;
+    stats.assigned = assignedCount;
+    stats.cancelled = cancelledCount;
+    stats.averageWaitSeconds = stats.assigned > 0 ? totalWaitSeconds / stats.assigned : 0.0;
+    stats.maxWaitSeconds = maxWaitSeconds;
+    stats.longestQueue = longestQueue;
+    return stats;
+}
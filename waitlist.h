@@ -0,0 +1,89 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include "ParkingSlot.h"
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+enum class WaitClass { EV_CHARGING, VIP, REGULAR };
+
+// Vehicles turned away for lack of a slot, queued per class. When a slot is
+// freed the lot asks next() for the best waiting vehicle that can take it
+// and parks it straight away. Each queue is an ordered set keyed by
+// (priority, arrival), so enqueue, removal and taking the head are O(log n).
+// Only the last WAITLIST_ASSIGNMENT_HISTORY assignments are remembered.
+class Waitlist {
+public:
+    static const int CLASSES = 3;
+    
+    struct Stats {
+        size_t waiting[CLASSES];   // current queue lengths
+        size_t enqueued;
+        size_t assigned;
+        size_t cancelled;
+        double averageWaitSeconds; // over assigned vehicles
+        double maxWaitSeconds;
+        size_t longestQueue;       // peak total length seen
+    };
+
+private:
+    struct Key {
+        int priority;  // higher first
+        uint64_t seq;  // then first come, first served
+        int waitId;
+        bool operator<(const Key& other) const {
+            return priority != other.priority ? priority > other.priority : seq < other.seq;
+        }
+    };
+    struct Waiting {
+        std::shared_ptr<Vehicle> vehicle;
+        WaitClass waitClass;
+        Key key;
+        time_t since;
+    };
+    
+    std::set<Key> queues[CLASSES];
+    std::unordered_map<int, Waiting> waiting;   // wait id -> entry
+    std::unordered_map<int, int> assignments;   // wait id -> ticket id, recent only
+    std::deque<int> assignmentOrder;            // oldest remembered wait id first
+    int nextWaitId;
+    uint64_t nextSeq;
+    size_t enqueuedCount;
+    size_t assignedCount;
+    size_t cancelledCount;
+    size_t longestQueue;
+    double totalWaitSeconds;
+    double maxWaitSeconds;
+    
+    static int priorityOf(const Vehicle& v);
+
+public:
+    Waitlist();
+    
+    static WaitClass classify(const Vehicle& v, bool holdsVipReservation);
+    
+    int enqueue(std::shared_ptr<Vehicle> v, WaitClass waitClass, time_t now);
+    bool cancel(int waitId);
+    
+    // Best waiting vehicle that fits `slot`, or -1. Looks at the queues the
+    // slot kind serves, most specific first, and only a few entries deep in
+    // each so a freed slot never triggers a full scan.
+    int next(const ParkingSlot& slot) const;
+    std::shared_ptr<Vehicle> vehicleOf(int waitId) const;
+    
+    // Removes the entry and records which ticket it received
+    void assigned(int waitId, int ticketId, time_t now);
+    
+    // Ticket id once assigned, 0 while still waiting, -1 if unknown,
+    // cancelled or assigned too long ago to be remembered
+    int ticketFor(int waitId) const;
+    size_t size() const;
+    Stats getStats() const;
+};
+
+#endif